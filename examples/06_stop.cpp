@@ -1,5 +1,6 @@
 #include <iostream>
 
+#include <ruckig/calculator_stop.hpp>
 #include <ruckig/ruckig.hpp>
 
 
@@ -26,25 +27,33 @@ int main() {
 
     // Generate the trajectory within the control loop
     std::cout << "t | position" << std::endl;
-    bool on_stop_trajectory = false;
     while (otg.update(input, output) == Result::Working) {
         std::cout << output.time << " | " << join(output.new_position) << std::endl;
+        output.pass_to_input(input);
 
         // Activate stop trajectory after 1s
-        if (output.time >= 1.0 && !on_stop_trajectory) {
-            std::cout << "Stop immediately." << std::endl;
-            on_stop_trajectory = true;
-
-            // Synchronization is disabled so that each DoF stops as fast as possible independently
-            input.control_interface = ControlInterface::Velocity;
-            input.synchronization = Synchronization::None;
-            input.target_velocity = {0.0, 0.0, 0.0};
-            input.target_acceleration = {0.0, 0.0, 0.0};
-            input.max_jerk = {12.0, 10.0, 8.0};
+        if (output.time >= 1.0) {
+            break;
         }
+    }
 
-        output.pass_to_input(input);
+    std::cout << "Stop immediately." << std::endl;
+
+    // The stop trajectory is calculated in closed form, each DoF stops as fast as possible independently
+    StopCalculator<3> stop;
+    Trajectory<3> stop_trajectory;
+    input.max_jerk = {12.0, 10.0, 8.0};
+    Result result = stop.calculate(input, stop_trajectory);
+    if (result != Result::Working) {
+        std::cout << "Stop calculation failed: " << stop.error.to_string() << std::endl;
+        return -1;
+    }
+
+    std::array<double, 3> new_position, new_velocity, new_acceleration;
+    for (double time = otg.delta_time; time < stop_trajectory.get_duration() + otg.delta_time; time += otg.delta_time) {
+        stop_trajectory.at_time(time, new_position, new_velocity, new_acceleration);
+        std::cout << output.time + time << " | " << join(new_position) << std::endl;
     }
 
-    std::cout << "Stop trajectory duration: " << output.trajectory.get_duration() << " [s]." << std::endl;
+    std::cout << "Stop trajectory duration: " << stop_trajectory.get_duration() << " [s]." << std::endl;
 }
@@ -5,6 +5,7 @@
 #include <numeric>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include <ruckig/profile.hpp>
 
@@ -135,6 +136,46 @@ public:
         return (t < t_min) || (a && a->left < t && t < a->right) || (b && b->left < t && t < b->right);
     }
 
+    //! Blocked interval together with an index, e.g. of its DoF
+    using IndexedInterval = std::pair<size_t, const Interval*>;
+
+    //! Write the blocked intervals that end after the given time together with the given index, and return the end of the output
+    template<class OutputIterator>
+    OutputIterator get_intervals_after(double t, size_t index, OutputIterator intervals) const {
+        if (a && a->right > t) {
+            *intervals = IndexedInterval {index, &a.value()};
+            ++intervals;
+        }
+        if (b && b->right > t) {
+            *intervals = IndexedInterval {index, &b.value()};
+            ++intervals;
+        }
+        return intervals;
+    }
+
+    //! @brief Find the earliest time from t on that is not within any of the given (open) blocked intervals
+    //!
+    //! The intervals are sorted by their left border and swept once, so that n intervals take O(n log n). Whenever the
+    //! time is pushed to the right border of an interval, it is rounded up by the given function (e.g. to the control
+    //! cycle). Returns the interval that the time was pushed to last, or last if the given time is not blocked.
+    template<class Iterator, class RoundFunction>
+    static Iterator synchronize(Iterator first, Iterator last, double& t, RoundFunction round) {
+        std::sort(first, last, [](const IndexedInterval& x, const IndexedInterval& y) { return x.second->left < y.second->left; });
+
+        Iterator limiting = last;
+        for (; first != last; ++first) {
+            if (first->second->left >= t) {
+                break; // All remaining intervals start later
+            }
+
+            if (t < first->second->right) {
+                t = round(first->second->right);
+                limiting = first;
+            }
+        }
+        return limiting;
+    }
+
     const Profile& get_profile(double t) const {
         if (b && t >= b->right) {
             return b->profile;
@@ -23,6 +23,19 @@ public:
     //! Profile information for a two-step profile
     std::array<double, 2> t, j, a, v, p;
 
+    //! Cheap and sufficient check whether the state is within the limits, so that no third-order position brake trajectory is needed
+    static bool is_within_position_limits(double v0, double a0, double vMax, double vMin, double aMax, double aMin, double jMax) {
+        const double v_at_a_zero = v0 + a0 * std::abs(a0) / (2 * jMax);
+        return (aMin <= a0) & (a0 <= aMax) & (vMin <= v0) & (v0 <= vMax) & (vMin <= v_at_a_zero) & (v_at_a_zero <= vMax);
+    }
+
+    //! Set to no braking
+    void reset() {
+        t = {0.0, 0.0};
+        j = {0.0, 0.0};
+        duration = 0.0;
+    }
+
     //! Calculate brake trajectory for third-order position interface
     void get_position_brake_trajectory(double v0, double a0, double vMax, double vMin, double aMax, double aMin, double jMax);
 
@@ -5,6 +5,7 @@
 #include <ruckig/calculator_cloud.hpp>
 #endif
 #include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
 #include <ruckig/trajectory.hpp>
 
 
@@ -18,6 +19,9 @@ class Calculator {
     }
 
 public:
+    //! Structured information about the error of the last calculation
+    CalculationError error;
+
     //! Calculator for state-to-state trajectories
     TargetCalculator<DOFs, CustomVector> target_calculator;
 
@@ -58,11 +62,17 @@ public:
 #if defined WITH_CLOUD_CLIENT
         if (use_waypoints_trajectory(input)) {
             result = waypoints_calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
+            error = {};
+            if (result < 0) {
+                error.result = result;
+            }
         } else {
             result = target_calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
+            error = target_calculator.error;
         }
 #else
         result = target_calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
+        error = target_calculator.error;
 #endif
 
         return result;
@@ -75,11 +85,17 @@ public:
 #if defined WITH_CLOUD_CLIENT
         if (use_waypoints_trajectory(input)) {
             result = waypoints_calculator.template continue_calculation<throw_error>(input, trajectory, delta_time, was_interrupted);
+            error = {};
+            if (result < 0) {
+                error.result = result;
+            }
         } else {
             result = target_calculator.template continue_calculation<throw_error>(input, trajectory, delta_time, was_interrupted);
+            error = target_calculator.error;
         }
 #else
         result = target_calculator.template continue_calculation<throw_error>(input, trajectory, delta_time, was_interrupted);
+        error = target_calculator.error;
 #endif
 
         return result;
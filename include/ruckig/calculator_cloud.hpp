@@ -150,6 +150,7 @@ public:
         traj.resize(result["profiles"].size() - 1);
 
         traj.continue_calculation_counter = 0;
+        traj.invalidate_extrema();
         traj.duration = result["duration"].template get<double>();
         traj.cumulative_times = result["cumulative_times"].template get<std::vector<double>>();
 
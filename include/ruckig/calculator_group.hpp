@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ruckig/block.hpp>
+#include <ruckig/calculator_target.hpp>
+#include <ruckig/error.hpp>
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/trajectory.hpp>
+#include <ruckig/utils.hpp>
+
+
+namespace ruckig {
+
+//! @brief Time synchronization of a group of state-to-state trajectories, e.g. of multiple robots with individual limits
+//!
+//! Step 1 is calculated for each member of the group, and the blocked intervals of all DoFs of all members are merged
+//! into a single synchronization. Then, Step 2 is calculated for each member at the common duration. All DoFs are time
+//! synchronized, ignoring the synchronization settings of the inputs. If any input has discrete durations, the common
+//! duration is rounded up to the control cycle. The inputs are not validated.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class GroupCalculator {
+    std::vector<TargetCalculator<DOFs, CustomVector>> calculators;
+
+    std::vector<Block::IndexedInterval> blocked_intervals; // For synchronization, indexed by the member
+    std::vector<Result> results;
+    std::vector<std::thread> threads;
+
+    //! For discrete durations, the synchronization is repeated at later cycles if Step 2 fails
+    constexpr static size_t max_discrete_synchronization_attempts {8};
+
+    //! Find the earliest duration that is not blocked for any DoF of any member
+    std::optional<double> synchronize(double t_start, bool discrete_duration) {
+        const auto round_duration = [this, discrete_duration](double t) {
+            return (discrete_duration && !std::isinf(t)) ? round_up_to_cycle(t, delta_time) : t;
+        };
+
+        for (const auto& calculator: calculators) {
+            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+                t_start = std::max(t_start, calculator.get_block(dof).t_min);
+            }
+        }
+        t_start = round_duration(t_start);
+
+        auto intervals_end = blocked_intervals.begin();
+        for (size_t member = 0; member < size(); ++member) {
+            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+                intervals_end = calculators[member].get_block(dof).get_intervals_after(t_start, member, intervals_end);
+            }
+        }
+
+        double t_sync = t_start;
+        Block::synchronize(blocked_intervals.begin(), intervals_end, t_sync, round_duration);
+        if (std::isinf(t_sync)) {
+            return std::nullopt;
+        }
+        return t_sync;
+    }
+
+    //! Calculate Step 2 of all members for the given duration, and return the first member that failed
+    std::optional<size_t> calculate_members(const std::vector<InputParameter<DOFs, CustomVector>>& inputs, std::vector<Trajectory<DOFs, CustomVector>>& trajectories, double duration) {
+        const auto calculate_member = [&](size_t member) {
+            results[member] = calculators[member].template calculate_at_duration<false>(inputs[member], trajectories[member], duration);
+        };
+
+        if (parallel && size() > 1) {
+            for (size_t member = 1; member < size(); ++member) {
+                threads.emplace_back(calculate_member, member);
+            }
+            calculate_member(0);
+            for (auto& thread: threads) {
+                thread.join();
+            }
+            threads.clear();
+
+        } else {
+            for (size_t member = 0; member < size(); ++member) {
+                calculate_member(member);
+            }
+        }
+
+        for (size_t member = 0; member < size(); ++member) {
+            if (results[member] != Result::Working) {
+                return member;
+            }
+        }
+        return std::nullopt;
+    }
+
+public:
+    size_t degrees_of_freedom; ///< Per member of the group
+
+    //! Time step between updates (cycle time) in [s], required for discrete durations
+    double delta_time {-1.0};
+
+    //! @brief Calculate Step 2 of the members in parallel threads
+    //!
+    //! This starts a thread per member in every calculation, so it is meant for offline planning of large groups rather
+    //! than for calculations within the control cycle. It requires linking against a thread library, e.g.
+    //! Threads::Threads in CMake.
+    bool parallel {false};
+
+    //! Error of the last calculation
+    CalculationError error;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit GroupCalculator(size_t members):
+        calculators(members), blocked_intervals(2 * members * DOFs), results(members), degrees_of_freedom(DOFs)
+    {
+        threads.reserve(members);
+    }
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit GroupCalculator(size_t members, double delta_time):
+        calculators(members), blocked_intervals(2 * members * DOFs), results(members), degrees_of_freedom(DOFs), delta_time(delta_time)
+    {
+        threads.reserve(members);
+    }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit GroupCalculator(size_t members, size_t dofs):
+        calculators(members, TargetCalculator<DOFs, CustomVector>(dofs)), blocked_intervals(2 * members * dofs), results(members), degrees_of_freedom(dofs)
+    {
+        threads.reserve(members);
+    }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit GroupCalculator(size_t members, size_t dofs, double delta_time):
+        calculators(members, TargetCalculator<DOFs, CustomVector>(dofs)), blocked_intervals(2 * members * dofs), results(members), degrees_of_freedom(dofs), delta_time(delta_time)
+    {
+        threads.reserve(members);
+    }
+
+    //! Number of members of the group
+    size_t size() const {
+        return calculators.size();
+    }
+
+    //! Calculate the time-synchronized trajectories of all members, the number of inputs and trajectories needs to match the group size
+    template<bool throw_error = false>
+    Result calculate(const std::vector<InputParameter<DOFs, CustomVector>>& inputs, std::vector<Trajectory<DOFs, CustomVector>>& trajectories) {
+        error = {};
+
+        if (inputs.size() != size() || trajectories.size() != size()) {
+            error = {Result::ErrorInvalidInput, CalculationStage::Validation, std::nullopt, std::numeric_limits<double>::quiet_NaN()};
+            if constexpr (throw_error) {
+                throw RuckigError("number of inputs " + std::to_string(inputs.size()) + " and trajectories " + std::to_string(trajectories.size()) + " should match the group size " + std::to_string(size()) + ".");
+            } else {
+                return Result::ErrorInvalidInput;
+            }
+        }
+
+        double t_min {0.0};
+        bool discrete_duration {false};
+        for (size_t member = 0; member < size(); ++member) {
+            const Result result = calculators[member].template calculate_blocks<throw_error>(inputs[member], trajectories[member]);
+            if (result != Result::Working) {
+                error = calculators[member].error;
+                return result;
+            }
+
+            t_min = std::max(t_min, inputs[member].minimum_duration.value_or(0.0));
+            discrete_duration = discrete_duration || (inputs[member].duration_discretization == DurationDiscretization::Discrete);
+        }
+
+        if (discrete_duration && delta_time <= 0.0) {
+            error = {Result::ErrorInvalidInput, CalculationStage::Validation, std::nullopt, std::numeric_limits<double>::quiet_NaN()};
+            if constexpr (throw_error) {
+                throw RuckigError("delta time (control rate) parameter " + std::to_string(delta_time) + " should be larger than zero.");
+            } else {
+                return Result::ErrorInvalidInput;
+            }
+        }
+
+        for (size_t attempt = 1; ; ++attempt) {
+            const std::optional<double> t_sync = synchronize(t_min, discrete_duration);
+            if (!t_sync) {
+                error = {Result::ErrorSynchronizationCalculation, CalculationStage::Synchronization, std::nullopt, std::numeric_limits<double>::quiet_NaN()};
+                if constexpr (throw_error) {
+                    throw RuckigError("error in time synchronization of the group.");
+                } else {
+                    return Result::ErrorSynchronizationCalculation;
+                }
+            }
+
+            const std::optional<size_t> failed_member = calculate_members(inputs, trajectories, t_sync.value());
+            if (!failed_member) {
+                return Result::Working;
+            }
+
+            // Step 2 might fail numerically at a rounded duration, then try the next control cycle
+            if (discrete_duration && attempt < max_discrete_synchronization_attempts) {
+                t_min = t_sync.value() + delta_time / 2;
+                continue;
+            }
+
+            const size_t member = failed_member.value();
+            error = calculators[member].error;
+            if constexpr (throw_error) {
+                throw RuckigError("error in group member " + std::to_string(member) + ": " + error.to_string());
+            } else {
+                return results[member];
+            }
+        }
+    }
+};
+
+} // namespace ruckig
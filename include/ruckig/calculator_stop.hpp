@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include <ruckig/block.hpp>
+#include <ruckig/brake.hpp>
+#include <ruckig/error.hpp>
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/profile.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/trajectory.hpp>
+#include <ruckig/velocity.hpp>
+
+
+namespace ruckig {
+
+//! @brief Calculation class for a stop trajectory to zero velocity and acceleration
+//!
+//! The stop trajectory of each DoF is calculated in closed form by the brake pre-trajectory and the extremal profile of
+//! the velocity interface (Step 1), so that the calculation time is bounded and independent of the target state of the
+//! input. Either each DoF stops as fast as possible, or all DoFs stop at the same time with an additional Step 2. Only the
+//! current state, the acceleration and jerk limits, and the enabled DoFs of the input are used; the input is not validated.
+//!
+//! The calculation is signal-handler-safe only for throw_error = false (as the error message is built as a string) and
+//! a trajectory that is already sized for the DoFs. With the cloud client, the trajectory is resized and might allocate.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class StopCalculator {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+    template<class T> using StandardVectorIntervals = StandardSizeVector<T, DOFs, 2*DOFs>;
+
+    constexpr static double eps {std::numeric_limits<double>::epsilon()};
+
+    StandardVector<Block, DOFs> blocks;
+    StandardVector<double, DOFs> inp_min_acceleration;
+    StandardVectorIntervals<Block::IndexedInterval> blocked_intervals; // For synchronization
+
+    //! Find the earliest time after the minimal durations that is not blocked for any DoF
+    double synchronize(double t_start) {
+        auto intervals_end = blocked_intervals.begin();
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            intervals_end = blocks[dof].get_intervals_after(t_start, dof, intervals_end);
+        }
+
+        double t_sync = t_start;
+        Block::synchronize(blocked_intervals.begin(), intervals_end, t_sync, [](double t) { return t; });
+        return t_sync;
+    }
+
+public:
+    size_t degrees_of_freedom;
+
+    //! Error of the last calculation
+    CalculationError error;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit StopCalculator(): degrees_of_freedom(DOFs) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit StopCalculator(size_t dofs): degrees_of_freedom(dofs) {
+        blocks.resize(dofs);
+        inp_min_acceleration.resize(dofs);
+        blocked_intervals.resize(2*dofs);
+    }
+
+    //! Calculate the stop trajectory from the current state of the input, all DoFs stop at the same time if synchronized
+    template<bool throw_error = false>
+    Result calculate(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, bool synchronized = false) {
+#if defined WITH_CLOUD_CLIENT
+        traj.resize(0);
+#endif
+        traj.invalidate_extrema();
+        error = {};
+
+        // Step 1: Brake pre-trajectory and time-optimal profile to zero velocity and acceleration
+        double t_max {0.0};
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            Profile& p = traj.profiles[0][dof];
+            inp_min_acceleration[dof] = inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof];
+
+            if (!inp.enabled[dof]) {
+                p.set_disabled(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof]);
+                blocks[dof].t_min = 0.0;
+                blocks[dof].a = std::nullopt;
+                blocks[dof].b = std::nullopt;
+                traj.independent_min_durations[dof] = 0.0;
+                continue;
+            }
+
+            bool found_profile {false};
+            p.set_boundary_for_velocity(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], 0.0, 0.0);
+            if (!std::isinf(inp.max_jerk[dof])) {
+                p.brake.get_velocity_brake_trajectory(inp.current_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                p.brake.finalize(p.p[0], p.v[0], p.a[0]);
+
+                VelocityThirdOrderStep1 step1 {p.v[0], p.a[0], 0.0, 0.0, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                found_profile = step1.get_profile(p, blocks[dof]);
+            } else {
+                p.brake.get_second_order_velocity_brake_trajectory();
+                p.brake.finalize_second_order(p.p[0], p.v[0], p.a[0]);
+
+                VelocitySecondOrderStep1 step1 {p.v[0], 0.0, inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                found_profile = step1.get_profile(p, blocks[dof]);
+            }
+
+            if (!found_profile) {
+                const bool has_zero_limits = (inp.max_acceleration[dof] == 0.0 || inp_min_acceleration[dof] == 0.0 || inp.max_jerk[dof] == 0.0);
+                const Result result = has_zero_limits ? Result::ErrorZeroLimits : Result::ErrorExecutionTimeCalculation;
+                error = {result, CalculationStage::Step1, dof, std::numeric_limits<double>::quiet_NaN()};
+                if constexpr (throw_error) {
+                    throw RuckigError("error in step 1 of stop trajectory, dof: " + std::to_string(dof));
+                } else {
+                    return result;
+                }
+            }
+
+            p = blocks[dof].p_min;
+            traj.independent_min_durations[dof] = blocks[dof].t_min;
+            t_max = std::max(t_max, blocks[dof].t_min);
+        }
+
+        traj.duration = synchronized ? synchronize(t_max) : t_max;
+        traj.cumulative_times[0] = traj.duration;
+        if (!synchronized) {
+            return Result::Working;
+        }
+
+        if (std::isinf(traj.duration)) {
+            error = {Result::ErrorSynchronizationCalculation, CalculationStage::Synchronization, std::nullopt, traj.duration};
+            if constexpr (throw_error) {
+                throw RuckigError("error in time synchronization of stop trajectory, the duration is infinite.");
+            } else {
+                return Result::ErrorSynchronizationCalculation;
+            }
+        }
+
+        // Step 2: All DoFs stop at the synchronized duration
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!inp.enabled[dof] || std::abs(traj.duration - blocks[dof].t_min) < 2*eps) {
+                continue;
+            }
+
+            Profile& p = traj.profiles[0][dof];
+            const double t_profile = traj.duration - p.brake.duration;
+
+            bool found_time_synchronization {false};
+            if (blocks[dof].a && std::abs(traj.duration - blocks[dof].a->right) < 2*eps) {
+                p = blocks[dof].a->profile;
+                found_time_synchronization = true;
+            } else if (blocks[dof].b && std::abs(traj.duration - blocks[dof].b->right) < 2*eps) {
+                p = blocks[dof].b->profile;
+                found_time_synchronization = true;
+            } else if (!std::isinf(inp.max_jerk[dof])) {
+                VelocityThirdOrderStep2 step2 {t_profile, p.v[0], p.a[0], 0.0, 0.0, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                found_time_synchronization = step2.get_profile(p);
+            } else {
+                VelocitySecondOrderStep2 step2 {t_profile, p.v[0], 0.0, inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                found_time_synchronization = step2.get_profile(p);
+            }
+
+            if (!found_time_synchronization) {
+                error = {Result::ErrorSynchronizationCalculation, CalculationStage::TimeSynchronization, dof, traj.duration};
+                if constexpr (throw_error) {
+                    throw RuckigError("error in step 2 of stop trajectory, dof: " + std::to_string(dof) + " for duration: " + std::to_string(traj.duration));
+                } else {
+                    return Result::ErrorSynchronizationCalculation;
+                }
+            }
+        }
+
+        return Result::Working;
+    }
+};
+
+} // namespace ruckig
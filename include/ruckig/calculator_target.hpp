@@ -2,11 +2,14 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <optional>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include <ruckig/block.hpp>
 #include <ruckig/brake.hpp>
@@ -14,6 +17,7 @@
 #include <ruckig/input_parameter.hpp>
 #include <ruckig/profile.hpp>
 #include <ruckig/position.hpp>
+#include <ruckig/result.hpp>
 #include <ruckig/trajectory.hpp>
 #include <ruckig/velocity.hpp>
 
@@ -25,14 +29,13 @@ template<size_t DOFs, template<class, size_t> class CustomVector = StandardVecto
 class TargetCalculator {
 private:
     template<class T> using Vector = CustomVector<T, DOFs>;
-    template<class T> using StandardVectorIntervals = StandardSizeVector<T, DOFs, 3*DOFs+1>;
+    template<class T> using StandardVectorIntervals = StandardSizeVector<T, DOFs, 2*DOFs>;
 
     constexpr static double eps {std::numeric_limits<double>::epsilon()};
     constexpr static bool return_error_at_maximal_duration {true};
 
-    Vector<double> new_phase_control, pd; // For phase synchronization
-    StandardVectorIntervals<double> possible_t_syncs;
-    StandardVectorIntervals<size_t> idx;
+    Vector<double> new_phase_control, new_phase_factor, pd; // For phase synchronization
+    StandardVectorIntervals<Block::IndexedInterval> blocked_intervals; // For synchronization
 
     StandardVector<Block, DOFs> blocks;
     StandardVector<double, DOFs> inp_min_velocity, inp_min_acceleration;
@@ -40,6 +43,25 @@ private:
     StandardVector<ControlInterface, DOFs> inp_per_dof_control_interface;
     StandardVector<Synchronization, DOFs> inp_per_dof_synchronization;
 
+    //! Stages of the resumable calculation
+    enum class Stage {
+        Step1,
+        Synchronization,
+        PhaseSynchronization,
+        TimeSynchronization,
+        Finished,
+    };
+
+    Stage stage {Stage::Finished};
+    bool has_blocks {false}; // Whether Step 1 was calculated for durations
+    size_t next_dof {0}; // Next DoF for time synchronization
+    std::optional<size_t> limiting_dof; // The DoF that doesn't need step 2
+
+    //! For discrete durations, the synchronization is repeated at later cycles if Step 2 fails
+    constexpr static size_t max_discrete_synchronization_attempts {8};
+    size_t discrete_synchronization_attempts {0};
+    std::optional<double> t_sync_lower_bound;
+
     //! Is the trajectory (in principle) phase synchronizable?
     bool is_input_collinear(const InputParameter<DOFs, CustomVector>& inp, Profile::Direction limiting_direction, size_t limiting_dof) {
         // Check that vectors pd, v0, a0, vf, af are collinear
@@ -103,183 +125,167 @@ private:
                 continue;
             }
 
+            // Branch-free deviation of all components, so that the first non-collinear DoF is rejected early
             const double current_scale = scale_vector->operator[](dof);
-            if (
-                (inp_per_dof_control_interface[dof] == ControlInterface::Position && std::abs(pd[dof] - pd_scale * current_scale) > eps)
-                || std::abs(inp.current_velocity[dof] - v0_scale * current_scale) > eps
-                || std::abs(inp.current_acceleration[dof] - a0_scale * current_scale) > eps
-                || std::abs(inp.target_velocity[dof] - vf_scale * current_scale) > eps
-                || std::abs(inp.target_acceleration[dof] - af_scale * current_scale) > eps
-            ) {
+            const double pd_deviation = (inp_per_dof_control_interface[dof] == ControlInterface::Position) ? std::abs(pd[dof] - pd_scale * current_scale) : 0.0;
+            const double deviation = std::max({
+                pd_deviation,
+                std::abs(inp.current_velocity[dof] - v0_scale * current_scale),
+                std::abs(inp.current_acceleration[dof] - a0_scale * current_scale),
+                std::abs(inp.target_velocity[dof] - vf_scale * current_scale),
+                std::abs(inp.target_acceleration[dof] - af_scale * current_scale),
+            });
+            if (deviation > eps) {
                 return false;
             }
 
-            new_phase_control[dof] = control_limiting * current_scale / scale_limiting;
+            new_phase_factor[dof] = current_scale / scale_limiting;
+            new_phase_control[dof] = control_limiting * new_phase_factor[dof];
         }
 
         return true;
     }
 
-    bool synchronize(std::optional<double> t_min, double& t_sync, std::optional<size_t>& limiting_dof, Vector<Profile>& profiles, bool discrete_duration, double delta_time) {
-        // Check for (degrees_of_freedom == 1 && !t_min && !discrete_duration) is now outside
+    //! Resolve the optional and per-DoF settings of the input
+    void set_per_dof_settings(const InputParameter<DOFs, CustomVector>& inp, size_t dof) {
+        inp_min_velocity[dof] = inp.min_velocity ? inp.min_velocity.value()[dof] : -inp.max_velocity[dof];
+        inp_min_acceleration[dof] = inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof];
+        inp_per_dof_control_interface[dof] = inp.per_dof_control_interface ? inp.per_dof_control_interface.value()[dof] : inp.control_interface;
+        inp_per_dof_synchronization[dof] = inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization;
+    }
 
-        // Possible t_syncs are the start times of the intervals and optional t_min
-        bool any_interval {false};
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            // Ignore DoFs without synchronization here
-            if (inp_per_dof_synchronization[dof] == Synchronization::None) {
-                possible_t_syncs[dof] = 0.0;
-                possible_t_syncs[degrees_of_freedom + dof] = std::numeric_limits<double>::infinity();
-                possible_t_syncs[2 * degrees_of_freedom + dof] = std::numeric_limits<double>::infinity();
-                continue;
-            }
+    //! Calculate the brake pre-trajectory (if input exceeds or will exceed limits) and set the boundary state of the profile
+    void calculate_brake(const InputParameter<DOFs, CustomVector>& inp, Profile& p, size_t dof) const {
+        switch (inp_per_dof_control_interface[dof]) {
+            case ControlInterface::Position: {
+                if (!std::isinf(inp.max_jerk[dof])) {
+                    // Most states are within the limits, skip the full brake calculation then
+                    if (BrakeProfile::is_within_position_limits(inp.current_velocity[dof], inp.current_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof])) {
+                        p.brake.reset();
+                    } else {
+                        p.brake.get_position_brake_trajectory(inp.current_velocity[dof], inp.current_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                    }
+                    // p.accel.get_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                } else if (!std::isinf(inp.max_acceleration[dof])) {
+                    p.brake.get_second_order_position_brake_trajectory(inp.current_velocity[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                    // p.accel.get_second_order_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                }
+                p.set_boundary(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_position[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
+            } break;
+            case ControlInterface::Velocity: {
+                if (!std::isinf(inp.max_jerk[dof])) {
+                    p.brake.get_velocity_brake_trajectory(inp.current_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                    // p.accel.get_velocity_brake_trajectory(inp.target_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                } else {
+                    p.brake.get_second_order_velocity_brake_trajectory();
+                    // p.accel.get_second_order_velocity_brake_trajectory();
+                }
+                p.set_boundary_for_velocity(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
+            } break;
+        }
 
-            possible_t_syncs[dof] = blocks[dof].t_min;
-            possible_t_syncs[degrees_of_freedom + dof] = blocks[dof].a ? blocks[dof].a->right : std::numeric_limits<double>::infinity();
-            possible_t_syncs[2 * degrees_of_freedom + dof] = blocks[dof].b ? blocks[dof].b->right : std::numeric_limits<double>::infinity();
-            any_interval |= blocks[dof].a || blocks[dof].b;
+        // Finalize pre & post-trajectories
+        if (!std::isinf(inp.max_jerk[dof])) {
+            p.brake.finalize(p.p[0], p.v[0], p.a[0]);
+            // p.accel.finalize(p.pf, p.vf, p.af);
+        } else if (!std::isinf(inp.max_acceleration[dof])) {
+            p.brake.finalize_second_order(p.p[0], p.v[0], p.a[0]);
+            // p.accel.finalize_second_order(p.pf, p.vf, p.af);
         }
-        possible_t_syncs[3 * degrees_of_freedom] = t_min.value_or(std::numeric_limits<double>::infinity());
-        any_interval |= t_min.has_value();
+    }
 
-        if (discrete_duration) {
-            for (auto& possible_t_sync: possible_t_syncs) {
-                if (std::isinf(possible_t_sync)) {
-                    continue;
+    //! Calculate the profile of a single DoF for the given duration (Step 2)
+    bool time_synchronize(const InputParameter<DOFs, CustomVector>& inp, Profile& p, size_t dof, double t_profile) const {
+        bool found_time_synchronization {false};
+        switch (inp_per_dof_control_interface[dof]) {
+            case ControlInterface::Position: {
+                if (!std::isinf(inp.max_jerk[dof])) {
+                    PositionThirdOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                    found_time_synchronization = step2.get_profile(p);
+                } else if (!std::isinf(inp.max_acceleration[dof])) {
+                    PositionSecondOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.pf, p.vf, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                    found_time_synchronization = step2.get_profile(p);
+                } else {
+                    PositionFirstOrderStep2 step2 {t_profile, p.p[0], p.pf, inp.max_velocity[dof], inp_min_velocity[dof]};
+                    found_time_synchronization = step2.get_profile(p);
                 }
-
-                const double remainder = std::fmod(possible_t_sync, delta_time); // in [0, delta_time)
-                if (remainder > eps) {
-                    possible_t_sync += delta_time - remainder;
+            } break;
+            case ControlInterface::Velocity: {
+                if (!std::isinf(inp.max_jerk[dof])) {
+                    VelocityThirdOrderStep2 step2 {t_profile, p.v[0], p.a[0], p.vf, p.af, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                    found_time_synchronization = step2.get_profile(p);
+                } else {
+                    VelocitySecondOrderStep2 step2 {t_profile, p.v[0], p.vf, inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                    found_time_synchronization = step2.get_profile(p);
                 }
-            }
+            } break;
         }
+        return found_time_synchronization;
+    }
 
-        // Test them in sorted order
-        auto idx_end = any_interval ? idx.end() : idx.begin() + degrees_of_freedom;
-        std::iota(idx.begin(), idx_end, 0);
-        std::sort(idx.begin(), idx_end, [&](size_t i, size_t j) { return possible_t_syncs[i] < possible_t_syncs[j]; });
+    //! Find the earliest time that is not blocked by any synchronized DoF, by sweeping over the blocked intervals once
+    bool synchronize(std::optional<double> t_min, double& t_sync, std::optional<size_t>& limiting_dof, Vector<Profile>& profiles, bool discrete_duration, double delta_time) {
+        // Check for (degrees_of_freedom == 1 && !t_min && !discrete_duration) is now outside
 
-        // Start at last tmin (or worse)
-        for (auto i = idx.begin() + degrees_of_freedom - 1; i != idx_end; ++i) {
-            const double possible_t_sync = possible_t_syncs[*i];
-            bool is_blocked {false};
-            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                if (inp_per_dof_synchronization[dof] == Synchronization::None) {
-                    continue; // inner dof loop
-                }
-                if (blocks[dof].is_blocked(possible_t_sync)) {
-                    is_blocked = true;
-                    break; // inner dof loop
-                }
-            }
-            if (is_blocked || possible_t_sync < t_min.value_or(0.0) || std::isinf(possible_t_sync)) {
-                continue;
-            }
+        const auto round_duration = [discrete_duration, delta_time](double t) {
+            return (discrete_duration && !std::isinf(t)) ? round_up_to_cycle(t, delta_time) : t;
+        };
 
-            t_sync = possible_t_sync;
-            if (*i == 3*degrees_of_freedom) { // Optional t_min
-                limiting_dof = std::nullopt;
-                return true;
+        // The synchronized duration is at least the largest minimal duration, ignoring DoFs without synchronization
+        double t_start = t_min.value_or(0.0);
+        std::optional<size_t> t_start_dof;
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (inp_per_dof_synchronization[dof] != Synchronization::None && blocks[dof].t_min > t_start) {
+                t_start = blocks[dof].t_min;
+                t_start_dof = dof;
             }
+        }
+        t_start = round_duration(t_start);
 
-            const auto div = std::div(static_cast<long>(*i), static_cast<long>(degrees_of_freedom));
-            limiting_dof = div.rem;
-            switch (div.quot) {
-                case 0: {
-                    profiles[limiting_dof.value()] = blocks[limiting_dof.value()].p_min;
-                } break;
-                case 1: {
-                    profiles[limiting_dof.value()] = blocks[limiting_dof.value()].a->profile;
-                } break;
-                case 2: {
-                    profiles[limiting_dof.value()] = blocks[limiting_dof.value()].b->profile;
-                } break;
+        // Collect the blocked intervals that might contain a time after t_start, and sweep over them
+        auto intervals_end = blocked_intervals.begin();
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (inp_per_dof_synchronization[dof] == Synchronization::None) {
+                continue;
             }
-            return true;
-        }
 
-        return false;
-    }
+            intervals_end = blocks[dof].get_intervals_after(t_start, dof, intervals_end);
+        }
 
-public:
-    size_t degrees_of_freedom;
+        t_sync = t_start;
+        const auto limiting_interval = Block::synchronize(blocked_intervals.begin(), intervals_end, t_sync, round_duration);
+        if (limiting_interval != intervals_end) {
+            t_start_dof = limiting_interval->first;
+        }
 
-    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
-    explicit TargetCalculator(): degrees_of_freedom(DOFs) { }
+        if (std::isinf(t_sync)) {
+            return false;
+        }
 
-    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
-    explicit TargetCalculator(size_t dofs): degrees_of_freedom(dofs) {
-        blocks.resize(dofs);
-        inp_min_velocity.resize(dofs);
-        inp_min_acceleration.resize(dofs);
-        inp_per_dof_control_interface.resize(dofs);
-        inp_per_dof_synchronization.resize(dofs);
-        new_phase_control.resize(dofs);
-        pd.resize(dofs);
-        possible_t_syncs.resize(3*dofs+1);
-        idx.resize(3*dofs+1);
+        limiting_dof = t_start_dof;
+        if (limiting_dof) {
+            profiles[limiting_dof.value()] = (limiting_interval != intervals_end) ? limiting_interval->second->profile : blocks[limiting_dof.value()].p_min;
+        }
+        return true;
     }
 
-    //! Calculate the time-optimal waypoint-based trajectory
+    //! Calculate the minimal duration and blocked intervals of each DoF (Step 1)
     template<bool throw_error>
-    Result calculate(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
-        was_interrupted = false;
-#if defined WITH_CLOUD_CLIENT
-        traj.resize(0);
-#endif
-
+    Result calculate_step1(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj) {
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
             auto& p = traj.profiles[0][dof];
 
-            inp_min_velocity[dof] = inp.min_velocity ? inp.min_velocity.value()[dof] : -inp.max_velocity[dof];
-            inp_min_acceleration[dof] = inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof];
-            inp_per_dof_control_interface[dof] = inp.per_dof_control_interface ? inp.per_dof_control_interface.value()[dof] : inp.control_interface;
-            inp_per_dof_synchronization[dof] = inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization;
+            set_per_dof_settings(inp, dof);
 
             if (!inp.enabled[dof]) {
-                p.p.back() = inp.current_position[dof];
-                p.v.back() = inp.current_velocity[dof];
-                p.a.back() = inp.current_acceleration[dof];
-                p.t_sum.back() = 0.0;
+                p.set_disabled(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof]);
                 blocks[dof].t_min = 0.0;
                 blocks[dof].a = std::nullopt;
                 blocks[dof].b = std::nullopt;
                 continue;
             }
 
-            // Calculate brake (if input exceeds or will exceed limits)
-            switch (inp_per_dof_control_interface[dof]) {
-                case ControlInterface::Position: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        p.brake.get_position_brake_trajectory(inp.current_velocity[dof], inp.current_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                        // p.accel.get_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                        p.brake.get_second_order_position_brake_trajectory(inp.current_velocity[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
-                        // p.accel.get_second_order_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
-                    }
-                    p.set_boundary(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_position[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
-                } break;
-                case ControlInterface::Velocity: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        p.brake.get_velocity_brake_trajectory(inp.current_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                        // p.accel.get_velocity_brake_trajectory(inp.target_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                    } else {
-                        p.brake.get_second_order_velocity_brake_trajectory();
-                        // p.accel.get_second_order_velocity_brake_trajectory();
-                    }
-                    p.set_boundary_for_velocity(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
-                } break;
-            }
-
-            // Finalize pre & post-trajectories
-            if (!std::isinf(inp.max_jerk[dof])) {
-                p.brake.finalize(p.p[0], p.v[0], p.a[0]);
-                // p.accel.finalize(p.pf, p.vf, p.af);
-            } else if (!std::isinf(inp.max_acceleration[dof])) {
-                p.brake.finalize_second_order(p.p[0], p.v[0], p.a[0]);
-                // p.accel.finalize_second_order(p.pf, p.vf, p.af);
-            }
+            calculate_brake(inp, p, dof);
 
             bool found_profile {false};
             switch (inp_per_dof_control_interface[dof]) {
@@ -309,6 +315,7 @@ public:
             if (!found_profile) {
                 const bool has_zero_limits = (inp.max_acceleration[dof] == 0.0 || inp_min_acceleration[dof] == 0.0 || inp.max_jerk[dof] == 0.0);
                 if (has_zero_limits) {
+                    error = {Result::ErrorZeroLimits, CalculationStage::Step1, dof, std::numeric_limits<double>::quiet_NaN()};
                     if constexpr (throw_error) {
                         throw RuckigError("zero limits conflict in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
                     } else {
@@ -316,6 +323,7 @@ public:
                     }
 
                 } else {
+                    error = {Result::ErrorExecutionTimeCalculation, CalculationStage::Step1, dof, std::numeric_limits<double>::quiet_NaN()};
                     if constexpr (throw_error) {
                         throw RuckigError("error in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
                     } else {
@@ -328,16 +336,28 @@ public:
             // std::cout << dof << " profile step1: " << blocks[dof].to_string() << std::endl;
         }
 
+        stage = Stage::Synchronization;
+        return Result::Working;
+    }
+
+    //! Find the synchronized duration of all DoFs and the limiting DoF
+    template<bool throw_error>
+    Result calculate_synchronization(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time) {
         const bool discrete_duration = (inp.duration_discretization == DurationDiscretization::Discrete);
         if (degrees_of_freedom == 1 && !inp.minimum_duration && !discrete_duration) {
             traj.duration = blocks[0].t_min;
             traj.profiles[0][0] = blocks[0].p_min;
             traj.cumulative_times[0] = traj.duration;
+            stage = Stage::Finished;
             return Result::Working;
         }
 
-        std::optional<size_t> limiting_dof; // The DoF that doesn't need step 2
-        const bool found_synchronization = synchronize(inp.minimum_duration, traj.duration, limiting_dof, traj.profiles[0], discrete_duration, delta_time);
+        limiting_dof = std::nullopt;
+        std::optional<double> t_min = inp.minimum_duration;
+        if (t_sync_lower_bound) {
+            t_min = std::max(t_min.value_or(0.0), t_sync_lower_bound.value());
+        }
+        const bool found_synchronization = synchronize(t_min, traj.duration, limiting_dof, traj.profiles[0], discrete_duration, delta_time);
         if (!found_synchronization) {
             bool has_zero_limits = false;
             for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
@@ -348,6 +368,7 @@ public:
             }
 
             if (has_zero_limits) {
+                error = {Result::ErrorZeroLimits, CalculationStage::Synchronization, std::nullopt, traj.duration};
                 if constexpr (throw_error) {
                     throw RuckigError("zero limits conflict with other degrees of freedom in time synchronization " + std::to_string(traj.duration));
                 } else {
@@ -355,6 +376,7 @@ public:
                 }
 
             } else {
+                error = {Result::ErrorSynchronizationCalculation, CalculationStage::Synchronization, std::nullopt, traj.duration};
                 if constexpr (throw_error) {
                     throw RuckigError("error in time synchronization: " + std::to_string(traj.duration));
                 } else {
@@ -377,6 +399,7 @@ public:
 
         if constexpr (return_error_at_maximal_duration) {
             if (traj.duration > 7.6e3) {
+                error = {Result::ErrorTrajectoryDuration, CalculationStage::Synchronization, limiting_dof, traj.duration};
                 return Result::ErrorTrajectoryDuration;
             }
         }
@@ -386,17 +409,30 @@ public:
             for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
                 traj.profiles[0][dof] = blocks[dof].p_min;
             }
+            stage = Stage::Finished;
             return Result::Working;
         }
 
         if (!discrete_duration && std::all_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::None; })) {
+            stage = Stage::Finished;
             return Result::Working;
         }
 
-        // Phase Synchronization
+        stage = Stage::PhaseSynchronization;
+        return Result::Working;
+    }
+
+    //! Synchronize the phase of all DoFs by copying the timing of the limiting DoF, if the input is collinear
+    void calculate_phase_synchronization(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj) {
+        next_dof = 0;
+        stage = Stage::TimeSynchronization;
+
         if (limiting_dof && std::any_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase; })) {
             const Profile& p_limiting = traj.profiles[0][limiting_dof.value()];
             if (is_input_collinear(inp, p_limiting.direction, limiting_dof.value())) {
+                // Third-order position profiles without brake can be scaled from the limiting profile directly
+                const bool is_limiting_scalable = inp_per_dof_synchronization[limiting_dof.value()] == Synchronization::Phase && inp_per_dof_control_interface[limiting_dof.value()] == ControlInterface::Position && !std::isinf(inp.max_jerk[limiting_dof.value()]) && p_limiting.brake.duration == 0.0;
+
                 bool found_time_synchronization {true};
                 for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
                     if (!inp.enabled[dof] || dof == limiting_dof || inp_per_dof_synchronization[dof] != Synchronization::Phase) {
@@ -404,6 +440,13 @@ public:
                     }
 
                     Profile& p = traj.profiles[0][dof];
+                    if (is_limiting_scalable && inp_per_dof_control_interface[dof] == ControlInterface::Position && !std::isinf(inp.max_jerk[dof]) && p.brake.duration == 0.0) {
+                        if (p.check_scaled(p_limiting, new_phase_factor[dof], new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof])) {
+                            p.limits = p_limiting.limits;
+                            continue;
+                        }
+                    }
+
                     const double t_profile = traj.duration - p.brake.duration - p.accel.duration;
 
                     p.t = p_limiting.t; // Copy timing information from limiting DoF
@@ -455,80 +498,308 @@ public:
                 }
 
                 if (found_time_synchronization && std::all_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase || s == Synchronization::None; })) {
+                    stage = Stage::Finished;
+                    return;
+                }
+            }
+        }
+    }
+
+    //! Calculate the profile of a single DoF for the synchronized duration (Step 2)
+    template<bool throw_error>
+    Result calculate_time_synchronization(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, size_t dof, double delta_time) {
+        const bool discrete_duration = (inp.duration_discretization == DurationDiscretization::Discrete);
+        const bool skip_synchronization = (dof == limiting_dof || inp_per_dof_synchronization[dof] == Synchronization::None) && !discrete_duration;
+        if (!inp.enabled[dof] || skip_synchronization) {
+            return Result::Working;
+        }
+
+        Profile& p = traj.profiles[0][dof];
+        const double t_profile = traj.duration - p.brake.duration - p.accel.duration;
+
+        if (inp_per_dof_synchronization[dof] == Synchronization::TimeIfNecessary && std::abs(inp.target_velocity[dof]) < eps && std::abs(inp.target_acceleration[dof]) < eps) {
+            p = blocks[dof].p_min;
+            return Result::Working;
+        }
+
+        // Check if the final time corresponds to an extremal profile calculated in step 1
+        // Use 2*eps because of numerical robustness in duration discretization
+        if (std::abs(t_profile - blocks[dof].t_min) < 2*eps) {
+            p = blocks[dof].p_min;
+            return Result::Working;
+        } else if (blocks[dof].a && std::abs(t_profile - blocks[dof].a->right) < 2*eps) {
+            p = blocks[dof].a->profile;
+            return Result::Working;
+        } else if (blocks[dof].b && std::abs(t_profile - blocks[dof].b->right) < 2*eps) {
+            p = blocks[dof].b->profile;
+            return Result::Working;
+        }
+
+        const bool found_time_synchronization = time_synchronize(inp, p, dof, t_profile);
+        if (!found_time_synchronization && discrete_duration && discrete_synchronization_attempts < max_discrete_synchronization_attempts) {
+            // Search upwards for the next cycle that is not blocked, starting again with the synchronization
+            discrete_synchronization_attempts += 1;
+            t_sync_lower_bound = traj.duration + delta_time / 2;
+            stage = Stage::Synchronization;
+            return Result::Working;
+
+        } else if (!found_time_synchronization) {
+            error = {Result::ErrorSynchronizationCalculation, CalculationStage::TimeSynchronization, dof, traj.duration};
+            if constexpr (throw_error) {
+                throw RuckigError("error in step 2 in dof: " + std::to_string(dof) + " for t sync: " + std::to_string(traj.duration) + " input: " + inp.to_string());
+            } else {
+                return Result::ErrorSynchronizationCalculation;
+            }
+        }
+        // std::cout << dof << " profile step2: " << p.to_string() << std::endl;
+
+        return Result::Working;
+    }
+
+    //! Run the calculation from the current stage, and yield between stages if the interruption duration is exceeded
+    template<bool throw_error>
+    Result resume_calculation(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
+        const auto start = std::chrono::steady_clock::now();
+        was_interrupted = false;
+
+        while (stage != Stage::Finished) {
+            Result result {Result::Working};
+            switch (stage) {
+                case Stage::Step1: {
+                    result = calculate_step1<throw_error>(inp, traj);
+                } break;
+                case Stage::Synchronization: {
+                    result = calculate_synchronization<throw_error>(inp, traj, delta_time);
+                } break;
+                case Stage::PhaseSynchronization: {
+                    calculate_phase_synchronization(inp, traj);
+                } break;
+                case Stage::TimeSynchronization: {
+                    if (next_dof < degrees_of_freedom) {
+                        result = calculate_time_synchronization<throw_error>(inp, traj, next_dof, delta_time);
+                        next_dof += 1;
+                    }
+                    if (stage == Stage::TimeSynchronization && next_dof >= degrees_of_freedom) {
+                        stage = Stage::Finished;
+                    }
+                } break;
+                case Stage::Finished: break;
+            }
+
+            if (result != Result::Working) {
+                stage = Stage::Finished;
+                return result;
+            }
+
+            if (stage != Stage::Finished && inp.interrupt_calculation_duration) {
+                const auto now = std::chrono::steady_clock::now();
+                const double calculation_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count() / 1000.0;
+                if (calculation_duration > inp.interrupt_calculation_duration.value()) {
+                    was_interrupted = true;
                     return Result::Working;
                 }
             }
         }
 
-        // Time Synchronization
+        return Result::Working;
+    }
+
+public:
+    size_t degrees_of_freedom;
+
+    //! Structured information about the error of the last calculation
+    CalculationError error;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TargetCalculator(): degrees_of_freedom(DOFs) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TargetCalculator(size_t dofs): degrees_of_freedom(dofs) {
+        blocks.resize(dofs);
+        inp_min_velocity.resize(dofs);
+        inp_min_acceleration.resize(dofs);
+        inp_per_dof_control_interface.resize(dofs);
+        inp_per_dof_synchronization.resize(dofs);
+        new_phase_control.resize(dofs);
+        new_phase_factor.resize(dofs);
+        pd.resize(dofs);
+        blocked_intervals.resize(2*dofs);
+    }
+
+    //! @brief Calculate the time-optimal waypoint-based trajectory
+    //!
+    //! If the interrupt_calculation_duration of the input is exceeded, the calculation yields after Step 1, after the
+    //! synchronization, or after the time synchronization of a DoF with was_interrupted set. The trajectory is then
+    //! incomplete until the calculation is finished via continue_calculation.
+    template<bool throw_error>
+    Result calculate(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
+#if defined WITH_CLOUD_CLIENT
+        traj.resize(0);
+#endif
+
+        traj.continue_calculation_counter = 0;
+        traj.invalidate_extrema();
+        stage = Stage::Step1;
+        has_blocks = false;
+        t_sync_lower_bound = std::nullopt;
+        discrete_synchronization_attempts = 0;
+        error = {};
+        return resume_calculation<throw_error>(inp, traj, delta_time, was_interrupted);
+    }
+
+    //! @brief Calculate a trajectory with a given duration by time synchronization (Step 2) only
+    //!
+    //! Every enabled DoF is synchronized to the given duration, ignoring the synchronization settings of the input.
+    //! This is cheaper than a full calculation, but fails with ErrorSynchronizationCalculation if the duration is not
+    //! feasible for any DoF. As Step 1 is skipped, the independent minimum durations of the trajectory are set to NaN.
+    template<bool throw_error>
+    Result calculate_with_duration(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double duration) {
+        stage = Stage::Finished;
+        has_blocks = false;
+#if defined WITH_CLOUD_CLIENT
+        traj.resize(0);
+#endif
+        traj.invalidate_extrema();
+        error = {};
+
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            const bool skip_synchronization = (dof == limiting_dof || inp_per_dof_synchronization[dof] == Synchronization::None) && !discrete_duration;
-            if (!inp.enabled[dof] || skip_synchronization) {
+            auto& p = traj.profiles[0][dof];
+            traj.independent_min_durations[dof] = std::numeric_limits<double>::quiet_NaN();
+
+            set_per_dof_settings(inp, dof);
+
+            if (!inp.enabled[dof]) {
+                p.set_disabled(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof]);
                 continue;
             }
 
-            Profile& p = traj.profiles[0][dof];
-            const double t_profile = traj.duration - p.brake.duration - p.accel.duration;
+            calculate_brake(inp, p, dof);
+
+            const double t_profile = duration - p.brake.duration - p.accel.duration;
+            if (t_profile < 0.0 || !time_synchronize(inp, p, dof, t_profile)) {
+                error = {Result::ErrorSynchronizationCalculation, CalculationStage::TimeSynchronization, dof, duration};
+                if constexpr (throw_error) {
+                    throw RuckigError("error in step 2 in dof: " + std::to_string(dof) + " for duration: " + std::to_string(duration) + " input: " + inp.to_string());
+                } else {
+                    return Result::ErrorSynchronizationCalculation;
+                }
+            }
+        }
+
+        traj.duration = duration;
+        traj.cumulative_times[0] = duration;
+        return Result::Working;
+    }
+
+    //! @brief Calculate only Step 1, so that the trajectory can be calculated for many durations afterwards
+    //!
+    //! The minimal duration and the blocked intervals of each DoF are available via get_block afterwards. Then, the
+    //! trajectory can be calculated for a given duration by calculate_at_duration, which only needs Step 2. The input
+    //! and the trajectory need to stay the same in between.
+    template<bool throw_error>
+    Result calculate_blocks(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj) {
+#if defined WITH_CLOUD_CLIENT
+        traj.resize(0);
+#endif
+        traj.invalidate_extrema();
+        error = {};
+
+        const Result result = calculate_step1<throw_error>(inp, traj);
+        has_blocks = (result == Result::Working);
+        stage = Stage::Finished;
+        return result;
+    }
+
+    //! Get the minimal duration and the blocked intervals of a DoF, as calculated by the last calculate_blocks call
+    const Block& get_block(size_t dof) const {
+        return blocks[dof];
+    }
+
+    //! Is the given duration blocked for any DoF, based on the last calculate_blocks call?
+    bool is_blocked(double duration) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (blocks[dof].is_blocked(duration)) {
+                return true;
+            }
+        }
+        return false;
+    }
 
-            if (inp_per_dof_synchronization[dof] == Synchronization::TimeIfNecessary && std::abs(inp.target_velocity[dof]) < eps && std::abs(inp.target_acceleration[dof]) < eps) {
-                p = blocks[dof].p_min;
+    //! @brief Calculate the trajectory for a given duration, based on Step 1 of the last calculate_blocks call
+    //!
+    //! Every enabled DoF is synchronized to the given duration, ignoring the synchronization settings of the input.
+    //! Blocked durations are rejected immediately, and durations at the border of a blocked interval reuse the profile of
+    //! Step 1.
+    template<bool throw_error>
+    Result calculate_at_duration(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double duration) {
+        traj.invalidate_extrema();
+        if (!has_blocks) {
+            error = {Result::Error, CalculationStage::Step1, std::nullopt, duration};
+            if constexpr (throw_error) {
+                throw RuckigError("step 1 needs to be calculated before a duration.");
+            } else {
+                return Result::Error;
+            }
+        }
+
+        error = {};
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!inp.enabled[dof]) {
                 continue;
             }
 
-            // Check if the final time corresponds to an extremal profile calculated in step 1
-            // Use 2*eps because of numerical robustness in duration discretization
-            if (std::abs(t_profile - blocks[dof].t_min) < 2*eps) {
-                p = blocks[dof].p_min;
+            Profile& p = traj.profiles[0][dof];
+            const Block& block = blocks[dof];
+            if (std::abs(duration - block.t_min) < 2*eps) {
+                p = block.p_min;
                 continue;
-            } else if (blocks[dof].a && std::abs(t_profile - blocks[dof].a->right) < 2*eps) {
-                p = blocks[dof].a->profile;
+            } else if (block.a && std::abs(duration - block.a->right) < 2*eps) {
+                p = block.a->profile;
                 continue;
-            } else if (blocks[dof].b && std::abs(t_profile - blocks[dof].b->right) < 2*eps) {
-                p = blocks[dof].b->profile;
+            } else if (block.b && std::abs(duration - block.b->right) < 2*eps) {
+                p = block.b->profile;
                 continue;
             }
 
-            bool found_time_synchronization {false};
-            switch (inp_per_dof_control_interface[dof]) {
-                case ControlInterface::Position: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        PositionThirdOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
-                        found_time_synchronization = step2.get_profile(p);
-                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                        PositionSecondOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.pf, p.vf, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]};
-                        found_time_synchronization = step2.get_profile(p);
-                    } else {
-                        PositionFirstOrderStep2 step2 {t_profile, p.p[0], p.pf, inp.max_velocity[dof], inp_min_velocity[dof]};
-                        found_time_synchronization = step2.get_profile(p);
-                    }
-                } break;
-                case ControlInterface::Velocity: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        VelocityThirdOrderStep2 step2 {t_profile, p.v[0], p.a[0], p.vf, p.af, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
-                        found_time_synchronization = step2.get_profile(p);
-                    } else {
-                        VelocitySecondOrderStep2 step2 {t_profile, p.v[0], p.vf, inp.max_acceleration[dof], inp_min_acceleration[dof]};
-                        found_time_synchronization = step2.get_profile(p);
-                    }
-                } break;
-            }
-            if (!found_time_synchronization) {
+            const double t_profile = duration - p.brake.duration - p.accel.duration;
+            if (block.is_blocked(duration) || t_profile < 0.0 || !time_synchronize(inp, p, dof, t_profile)) {
+                error = {Result::ErrorSynchronizationCalculation, CalculationStage::TimeSynchronization, dof, duration};
                 if constexpr (throw_error) {
-                    throw RuckigError("error in step 2 in dof: " + std::to_string(dof) + " for t sync: " + std::to_string(traj.duration) + " input: " + inp.to_string());
+                    throw RuckigError("error in step 2 in dof: " + std::to_string(dof) + " for duration: " + std::to_string(duration) + " input: " + inp.to_string());
                 } else {
                     return Result::ErrorSynchronizationCalculation;
                 }
             }
-            // std::cout << dof << " profile step2: " << p.to_string() << std::endl;
         }
 
+        traj.duration = duration;
+        traj.cumulative_times[0] = duration;
         return Result::Working;
     }
 
-    //! Continue the trajectory calculation
+    //! Calculate the trajectory for each of the given durations and write the results, the trajectory keeps the last one
+    template<class DurationIterator, class ResultIterator>
+    void calculate_at_durations(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, DurationIterator first, DurationIterator last, ResultIterator results) {
+        for (; first != last; ++first, ++results) {
+            *results = calculate_at_duration<false>(inp, traj, *first);
+        }
+    }
+
+    //! Continue an interrupted trajectory calculation, with the same input and trajectory as before
     template<bool throw_error>
-    Result continue_calculation(const InputParameter<DOFs, CustomVector>&, Trajectory<DOFs, CustomVector>&, double, bool&) {
-        return Result::Error;
+    Result continue_calculation(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
+        if (stage == Stage::Finished) {
+            error = {Result::Error, CalculationStage::Continuation, std::nullopt, std::numeric_limits<double>::quiet_NaN()};
+            if constexpr (throw_error) {
+                throw RuckigError("no interrupted calculation to continue.");
+            } else {
+                return Result::Error;
+            }
+        }
+
+        traj.continue_calculation_counter += 1;
+        traj.invalidate_extrema();
+        return resume_calculation<throw_error>(inp, traj, delta_time, was_interrupted);
     }
 };
 
@@ -150,186 +150,288 @@ public:
     }
 #endif
 
-    //! Validate the input for trajectory calculation
+    //! Validate the kinematic limits of a single DoF
     template<bool throw_validation_error = true>
-    bool validate(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            const double jMax = max_jerk[dof];
-            if (std::isnan(jMax) || jMax < 0.0) {
+    bool validate_limits_of_dof(size_t dof) const {
+        const double jMax = max_jerk[dof];
+        if (std::isnan(jMax) || jMax < 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("maximum jerk limit " + std::to_string(jMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+            }
+            return false;
+        }
+
+        const double aMax = max_acceleration[dof];
+        if (std::isnan(aMax) || aMax < 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("maximum acceleration limit " + std::to_string(aMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+            }
+            return false;
+        }
+
+        const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
+        if (std::isnan(aMin) || aMin > 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("minimum acceleration limit " + std::to_string(aMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
+            }
+            return false;
+        }
+
+        auto control_interface_ = per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface;
+        if (control_interface_ == ControlInterface::Position) {
+            const double vMax = max_velocity[dof];
+            if (std::isnan(vMax) || vMax < 0.0) {
                 if constexpr (throw_validation_error) {
-                    throw RuckigError("maximum jerk limit " + std::to_string(jMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+                    throw RuckigError("maximum velocity limit " + std::to_string(vMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
                 }
                 return false;
             }
 
-            const double aMax = max_acceleration[dof];
-            if (std::isnan(aMax) || aMax < 0.0) {
+            const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
+            if (std::isnan(vMin) || vMin > 0.0) {
                 if constexpr (throw_validation_error) {
-                    throw RuckigError("maximum acceleration limit " + std::to_string(aMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+                    throw RuckigError("minimum velocity limit " + std::to_string(vMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
                 }
                 return false;
             }
+        }
+
+        return true;
+    }
+
+    //! Validate the kinematic limits of all DoFs, and set the first invalid DoF
+    template<bool throw_validation_error = true>
+    bool validate_limits(std::optional<size_t>& invalid_dof) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!validate_limits_of_dof<throw_validation_error>(dof)) {
+                invalid_dof = dof;
+                return false;
+            }
+        }
+        return true;
+    }
 
+    //! Validate the kinematic limits of all DoFs
+    template<bool throw_validation_error = true>
+    bool validate_limits() const {
+        std::optional<size_t> invalid_dof;
+        return validate_limits<throw_validation_error>(invalid_dof);
+    }
+
+    //! @brief Is the current and target state of all DoFs valid with respect to the (already validated) limits?
+    //!
+    //! This is a branch-free version of validate_state without error messages. All checks of a DoF are combined
+    //! without short-circuiting, so that the loop has no data-dependent branches and is cheap in the common case.
+    bool is_state_valid(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        const bool ignore_current_limits = !check_current_state_within_limits;
+        const bool ignore_target_limits = !check_target_state_within_limits;
+
+        bool is_valid {true};
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            const double jMax = max_jerk[dof];
+            const double aMax = max_acceleration[dof];
             const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
-            if (std::isnan(aMin) || aMin > 0.0) {
+            const double vMax = max_velocity[dof];
+            const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
+            const double p0 = current_position[dof], v0 = current_velocity[dof], a0 = current_acceleration[dof];
+            const double pf = target_position[dof], vf = target_velocity[dof], af = target_acceleration[dof];
+
+            const bool is_current_acceleration_valid = !(a0 > aMax) & !(a0 < aMin);
+            const bool is_target_acceleration_valid = !(af > aMax) & !(af < aMin);
+            const bool is_current_velocity_valid = !(v0 > vMax) & !(v0 < vMin)
+                & !((a0 > 0) & (jMax > 0) & (v_at_a_zero(v0, a0, jMax) > vMax))
+                & !((a0 < 0) & (jMax > 0) & (v_at_a_zero(v0, a0, -jMax) < vMin));
+            const bool is_target_velocity_valid = !(vf > vMax) & !(vf < vMin)
+                & !((af < 0) & (jMax > 0) & (v_at_a_zero(vf, af, jMax) > vMax))
+                & !((af > 0) & (jMax > 0) & (v_at_a_zero(vf, af, -jMax) < vMin));
+
+            const bool is_velocity_interface = (per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface) == ControlInterface::Velocity;
+
+            is_valid &= !std::isnan(a0) & !std::isnan(af) & !std::isnan(v0) & !std::isnan(vf)
+                & (ignore_current_limits | is_current_acceleration_valid)
+                & (ignore_target_limits | is_target_acceleration_valid)
+                & (is_velocity_interface | (!std::isnan(p0) & !std::isnan(pf)
+                    & (ignore_current_limits | is_current_velocity_valid)
+                    & (ignore_target_limits | is_target_velocity_valid)));
+        }
+        return is_valid;
+    }
+
+    //! Validate the current and target state of a single DoF with respect to the (already validated) limits
+    template<bool throw_validation_error = true>
+    bool validate_state_of_dof(size_t dof, bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        const double jMax = max_jerk[dof];
+        const double aMax = max_acceleration[dof];
+        const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
+
+        const double a0 = current_acceleration[dof];
+        if (std::isnan(a0)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+        const double af = target_acceleration[dof];
+        if (std::isnan(af)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+
+        if (check_current_state_within_limits) {
+            if (a0 > aMax) {
                 if constexpr (throw_validation_error) {
-                    throw RuckigError("minimum acceleration limit " + std::to_string(aMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
+                    throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " exceeds its maximum acceleration limit " + std::to_string(aMax) + ".");
                 }
                 return false;
             }
+            if (a0 < aMin) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " undercuts its minimum acceleration limit " + std::to_string(aMin) + ".");
+                }
+                return false;
+            }
+        }
+        if (check_target_state_within_limits) {
+            if (af > aMax) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " exceeds its maximum acceleration limit " + std::to_string(aMax) + ".");
+                }
+                return false;
+            }
+            if (af < aMin) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " undercuts its minimum acceleration limit " + std::to_string(aMin) + ".");
+                }
+                return false;
+            }
+        }
+
+        const double v0 = current_velocity[dof];
+        if (std::isnan(v0)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+        const double vf = target_velocity[dof];
+        if (std::isnan(vf)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
 
-            const double a0 = current_acceleration[dof];
-            if (std::isnan(a0)) {
+        auto control_interface_ = per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface;
+        if (control_interface_ == ControlInterface::Position) {
+            const double p0 = current_position[dof];
+            if (std::isnan(p0)) {
                 if constexpr (throw_validation_error) {
-                    throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+                    throw RuckigError("current position " + std::to_string(p0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
                 }
                 return false;
             }
-            const double af = target_acceleration[dof];
-            if (std::isnan(af)) {
+            const double pf = target_position[dof];
+            if (std::isnan(pf)) {
                 if constexpr (throw_validation_error) {
-                    throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+                    throw RuckigError("target position " + std::to_string(pf) + " of DoF " + std::to_string(dof) + " should be a valid number.");
                 }
                 return false;
             }
 
+            const double vMax = max_velocity[dof];
+            const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
+
             if (check_current_state_within_limits) {
-                if (a0 > aMax) {
+                if (v0 > vMax) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " exceeds its maximum acceleration limit " + std::to_string(aMax) + ".");
+                        throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " exceeds its maximum velocity limit " + std::to_string(vMax) + ".");
                     }
                     return false;
                 }
-                if (a0 < aMin) {
+                if (v0 < vMin) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("current acceleration " + std::to_string(a0) + " of DoF " + std::to_string(dof) + " undercuts its minimum acceleration limit " + std::to_string(aMin) + ".");
+                        throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " undercuts its minimum velocity limit " + std::to_string(vMin) + ".");
                     }
                     return false;
                 }
             }
             if (check_target_state_within_limits) {
-                if (af > aMax) {
+                if (vf > vMax) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " exceeds its maximum acceleration limit " + std::to_string(aMax) + ".");
+                        throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " exceeds its maximum velocity limit " + std::to_string(vMax) + ".");
                     }
                     return false;
                 }
-                if (af < aMin) {
+                if (vf < vMin) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("target acceleration " + std::to_string(af) + " of DoF " + std::to_string(dof) + " undercuts its minimum acceleration limit " + std::to_string(aMin) + ".");
+                        throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " undercuts its minimum velocity limit " + std::to_string(vMin) + ".");
                     }
                     return false;
                 }
             }
 
-            const double v0 = current_velocity[dof];
-            if (std::isnan(v0)) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
-                }
-                return false;
-            }
-            const double vf = target_velocity[dof];
-            if (std::isnan(vf)) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " should be a valid number.");
-                }
-                return false;
-            }
-
-            auto control_interface_ = per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface;
-            if (control_interface_ == ControlInterface::Position) {
-                const double p0 = current_position[dof];
-                if (std::isnan(p0)) {
+            if (check_current_state_within_limits) {
+                if (a0 > 0 && jMax > 0 && v_at_a_zero(v0, a0, jMax) > vMax) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("current position " + std::to_string(p0) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+                        throw RuckigError("DoF " + std::to_string(dof) + " will inevitably reach a velocity " + std::to_string(v_at_a_zero(v0, a0, jMax)) + " from the current kinematic state that will exceed its maximum velocity limit " + std::to_string(vMax) + ".");
                     }
                     return false;
                 }
-                const double pf = target_position[dof];
-                if (std::isnan(pf)) {
+                if (a0 < 0 && jMax > 0 && v_at_a_zero(v0, a0, -jMax) < vMin) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("target position " + std::to_string(pf) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+                        throw RuckigError("DoF " + std::to_string(dof) + " will inevitably reach a velocity " + std::to_string(v_at_a_zero(v0, a0, -jMax)) + " from the current kinematic state that will undercut its minimum velocity limit " + std::to_string(vMin) + ".");
                     }
                     return false;
                 }
-
-                const double vMax = max_velocity[dof];
-                if (std::isnan(vMax) || vMax < 0.0) {
+            }
+            if (check_target_state_within_limits) {
+                if (af < 0 && jMax > 0 && v_at_a_zero(vf, af, jMax) > vMax) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("maximum velocity limit " + std::to_string(vMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+                        throw RuckigError("DoF " + std::to_string(dof) + " will inevitably have reached a velocity " + std::to_string(v_at_a_zero(vf, af, jMax)) + " from the target kinematic state that will exceed its maximum velocity limit " + std::to_string(vMax) + ".");
                     }
                     return false;
                 }
-
-                const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
-                if (std::isnan(vMin) || vMin > 0.0) {
+                if (af > 0 && jMax > 0 && v_at_a_zero(vf, af, -jMax) < vMin) {
                     if constexpr (throw_validation_error) {
-                        throw RuckigError("minimum velocity limit " + std::to_string(vMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
+                        throw RuckigError("DoF " + std::to_string(dof) + " will inevitably have reached a velocity " + std::to_string(v_at_a_zero(vf, af, -jMax)) + " from the target kinematic state that will undercut its minimum velocity limit " + std::to_string(vMin) + ".");
                     }
                     return false;
                 }
+            }
+        }
 
-                if (check_current_state_within_limits) {
-                    if (v0 > vMax) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " exceeds its maximum velocity limit " + std::to_string(vMax) + ".");
-                        }
-                        return false;
-                    }
-                    if (v0 < vMin) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("current velocity " + std::to_string(v0) + " of DoF " + std::to_string(dof) + " undercuts its minimum velocity limit " + std::to_string(vMin) + ".");
-                        }
-                        return false;
-                    }
-                }
-                if (check_target_state_within_limits) {
-                    if (vf > vMax) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " exceeds its maximum velocity limit " + std::to_string(vMax) + ".");
-                        }
-                        return false;
-                    }
-                    if (vf < vMin) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("target velocity " + std::to_string(vf) + " of DoF " + std::to_string(dof) + " undercuts its minimum velocity limit " + std::to_string(vMin) + ".");
-                        }
-                        return false;
-                    }
-                }
+        return true;
+    }
 
-                if (check_current_state_within_limits) {
-                    if (a0 > 0 && jMax > 0 && v_at_a_zero(v0, a0, jMax) > vMax) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("DoF " + std::to_string(dof) + " will inevitably reach a velocity " + std::to_string(v_at_a_zero(v0, a0, jMax)) + " from the current kinematic state that will exceed its maximum velocity limit " + std::to_string(vMax) + ".");
-                        }
-                        return false;
-                    }
-                    if (a0 < 0 && jMax > 0 && v_at_a_zero(v0, a0, -jMax) < vMin) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("DoF " + std::to_string(dof) + " will inevitably reach a velocity " + std::to_string(v_at_a_zero(v0, a0, -jMax)) + " from the current kinematic state that will undercut its minimum velocity limit " + std::to_string(vMin) + ".");
-                        }
-                        return false;
-                    }
-                }
-                if (check_target_state_within_limits) {
-                    if (af < 0 && jMax > 0 && v_at_a_zero(vf, af, jMax) > vMax) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("DoF " + std::to_string(dof) + " will inevitably have reached a velocity " + std::to_string(v_at_a_zero(vf, af, jMax)) + " from the target kinematic state that will exceed its maximum velocity limit " + std::to_string(vMax) + ".");
-                        }
-                        return false;
-                    }
-                    if (af > 0 && jMax > 0 && v_at_a_zero(vf, af, -jMax) < vMin) {
-                        if constexpr (throw_validation_error) {
-                            throw RuckigError("DoF " + std::to_string(dof) + " will inevitably have reached a velocity " + std::to_string(v_at_a_zero(vf, af, -jMax)) + " from the target kinematic state that will undercut its minimum velocity limit " + std::to_string(vMin) + ".");
-                        }
-                        return false;
-                    }
-                }
+    //! Validate the current and target state of all DoFs with respect to the (already validated) limits, and set the first invalid DoF
+    template<bool throw_validation_error = true>
+    bool validate_state(std::optional<size_t>& invalid_dof, bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        // Fast path for the common case, the detailed check below is only required for the error message and DoF
+        if (is_state_valid(check_current_state_within_limits, check_target_state_within_limits)) {
+            return true;
+        }
+
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!validate_state_of_dof<throw_validation_error>(dof, check_current_state_within_limits, check_target_state_within_limits)) {
+                invalid_dof = dof;
+                return false;
             }
         }
+        return true;
+    }
 
+    //! Validate the current and target state of all DoFs with respect to the (already validated) limits
+    template<bool throw_validation_error = true>
+    bool validate_state(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        std::optional<size_t> invalid_dof;
+        return validate_state<throw_validation_error>(invalid_dof, check_current_state_within_limits, check_target_state_within_limits);
+    }
+
+    //! Validate the settings for intermediate positions
+    template<bool throw_validation_error = true>
+    bool validate_intermediate_positions() const {
         if (!intermediate_positions.empty() && control_interface == ControlInterface::Position) {
             if (minimum_duration || duration_discretization != DurationDiscretization::Continuous) {
                 if constexpr (throw_validation_error) {
@@ -359,6 +461,36 @@ public:
         return true;
     }
 
+    //! Validate the input for trajectory calculation
+    template<bool throw_validation_error = true>
+    bool validate(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        return validate_limits<throw_validation_error>()
+            && validate_state<throw_validation_error>(check_current_state_within_limits, check_target_state_within_limits)
+            && validate_intermediate_positions<throw_validation_error>();
+    }
+
+    //! Are the kinematic limits (and control interfaces) equal to the ones of the other input?
+    bool has_equal_limits(const InputParameter<DOFs, CustomVector>& rhs) const {
+        return max_velocity == rhs.max_velocity
+            && max_acceleration == rhs.max_acceleration
+            && max_jerk == rhs.max_jerk
+            && min_velocity == rhs.min_velocity
+            && min_acceleration == rhs.min_acceleration
+            && control_interface == rhs.control_interface
+            && per_dof_control_interface == rhs.per_dof_control_interface;
+    }
+
+    //! Copy the kinematic limits (and control interfaces) from the other input
+    void copy_limits_from(const InputParameter<DOFs, CustomVector>& rhs) {
+        max_velocity = rhs.max_velocity;
+        max_acceleration = rhs.max_acceleration;
+        max_jerk = rhs.max_jerk;
+        min_velocity = rhs.min_velocity;
+        min_acceleration = rhs.min_acceleration;
+        control_interface = rhs.control_interface;
+        per_dof_control_interface = rhs.per_dof_control_interface;
+    }
+
     bool operator!=(const InputParameter<DOFs, CustomVector>& rhs) const {
         return !(
             current_position == rhs.current_position
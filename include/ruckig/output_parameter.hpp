@@ -4,8 +4,10 @@
 #include <iomanip>
 #include <type_traits>
 
+#include <ruckig/result.hpp>
 #include <ruckig/trajectory.hpp>
 #include <ruckig/utils.hpp>
+#include <ruckig/waypoint_queue.hpp>
 
 
 namespace ruckig {
@@ -49,6 +51,9 @@ public:
     //! Computational duration of the last update call
     double calculation_duration; // [µs]
 
+    //! Structured information about the error of the last calculation, to be formatted outside of the real-time path
+    CalculationError error;
+
     template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
     OutputParameter(): degrees_of_freedom(DOFs) { }
 
@@ -87,6 +92,21 @@ public:
         }
     }
 
+    //! Pass the new state and the next window of waypoints to the input, and consume the waypoint of a completed section in constant time
+    void pass_to_input(InputParameter<DOFs, CustomVector>& input, WaypointQueue<DOFs, CustomVector>& waypoints) const {
+        input.current_position = new_position;
+        input.current_velocity = new_velocity;
+        input.current_acceleration = new_acceleration;
+
+        // The last waypoint of the window is consumed once the trajectory reached it as its target
+        const bool is_target_reached = input.intermediate_positions.empty() && time > trajectory.get_duration() && !waypoints.empty() && waypoints.front() == input.target_position;
+        if (did_section_change || is_target_reached) {
+            waypoints.pop();
+        }
+
+        waypoints.write_to_input(input);
+    }
+
     std::string to_string() const {
         std::stringstream ss;
         ss << "\nout.new_position = [" << join(new_position, true) << "]\n";
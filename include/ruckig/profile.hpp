@@ -15,12 +15,12 @@
 
 namespace ruckig {
 
-//! Information about the position extrema
+//! Information about the extrema of a kinematic value (e.g. the position)
 struct Bound {
-    //! The extreme position
+    //! The extreme values
     double min, max;
 
-    //! Time when the positions are reached
+    //! Time when the values are reached
     double t_min, t_max;
 };
 
@@ -217,10 +217,12 @@ public:
         const double vUppLim = (direction == Profile::Direction::UP ? vMax : vMin) + v_eps;
         const double vLowLim = (direction == Profile::Direction::UP ? vMin : vMax) - v_eps;
 
+        this->control_signs = control_signs;
+        this->limits = limits;
+
+        // Integrate one kinematic order after another, so that most profiles are rejected before the position is integrated
         for (size_t i = 0; i < 7; ++i) {
             a[i+1] = a[i] + t[i] * j[i];
-            v[i+1] = v[i] + t[i] * (a[i] + t[i] * j[i] / 2);
-            p[i+1] = p[i] + t[i] * (v[i] + t[i] * (a[i] / 2 + t[i] * j[i] / 6));
 
             if constexpr (limits == ReachedLimits::ACC0_ACC1_VEL || limits == ReachedLimits::ACC0_ACC1 || limits == ReachedLimits::ACC0_VEL || limits == ReachedLimits::ACC1_VEL || limits == ReachedLimits::VEL) {
                 if (i == 2) {
@@ -245,6 +247,18 @@ public:
                     }
                 }
             }
+        }
+
+        const double aUppLim = (direction == Profile::Direction::UP ? aMax : aMin) + a_eps;
+        const double aLowLim = (direction == Profile::Direction::UP ? aMin : aMax) - a_eps;
+        if (!(std::abs(a.back() - af) < a_precision
+            && a[1] >= aLowLim && a[3] >= aLowLim && a[5] >= aLowLim
+            && a[1] <= aUppLim && a[3] <= aUppLim && a[5] <= aUppLim)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < 7; ++i) {
+            v[i+1] = v[i] + t[i] * (a[i] + t[i] * j[i] / 2);
 
             if (i > 1 && a[i+1] * a[i] < -std::numeric_limits<double>::epsilon()) {
                 const double v_a_zero = v[i] - (a[i] * a[i]) / (2 * j[i]);
@@ -254,19 +268,19 @@ public:
             }
         }
 
-        this->control_signs = control_signs;
-        this->limits = limits;
+        // Velocity limit can be broken in the beginning if both initial velocity and acceleration are too high
+        if (!(std::abs(v.back() - vf) < v_precision
+            && v[3] <= vUppLim && v[4] <= vUppLim && v[5] <= vUppLim && v[6] <= vUppLim
+            && v[3] >= vLowLim && v[4] >= vLowLim && v[5] >= vLowLim && v[6] >= vLowLim)) {
+            return false;
+        }
 
-        const double aUppLim = (direction == Profile::Direction::UP ? aMax : aMin) + a_eps;
-        const double aLowLim = (direction == Profile::Direction::UP ? aMin : aMax) - a_eps;
+        for (size_t i = 0; i < 7; ++i) {
+            p[i+1] = p[i] + t[i] * (v[i] + t[i] * (a[i] / 2 + t[i] * j[i] / 6));
+        }
 
-        // Velocity limit can be broken in the beginning if both initial velocity and acceleration are too high
         // std::cout << std::setprecision(16) << "target: " << std::abs(p.back() - pf) << " " << std::abs(v.back() - vf) << " " << std::abs(a.back() - af) << " T: " << t_sum.back() << " " << to_string() << std::endl;
-        return std::abs(p.back() - pf) < p_precision && std::abs(v.back() - vf) < v_precision && std::abs(a.back() - af) < a_precision
-            && a[1] >= aLowLim && a[3] >= aLowLim && a[5] >= aLowLim
-            && a[1] <= aUppLim && a[3] <= aUppLim && a[5] <= aUppLim
-            && v[3] <= vUppLim && v[4] <= vUppLim && v[5] <= vUppLim && v[6] <= vUppLim
-            && v[3] >= vLowLim && v[4] >= vLowLim && v[5] >= vLowLim && v[6] >= vLowLim;
+        return std::abs(p.back() - pf) < p_precision;
     }
 
     template<ControlSigns control_signs, ReachedLimits limits>
@@ -280,6 +294,50 @@ public:
         return (std::abs(jf) < std::abs(jMax) + j_eps) && check_with_timing<control_signs, limits>(tf, jf, vMax, vMin, aMax, aMin);
     }
 
+    //! @brief Scale the given third-order position profile without re-integration, e.g. for phase synchronization
+    //!
+    //! Equal to check_with_timing with the timing of the profile and jf scaled by the factor, if the boundary states are
+    //! scaled by the same factor. The jerk, acceleration, and velocity of each phase are scaled, and the position is
+    //! offset to the own initial position.
+    bool check_scaled(const Profile& profile, double factor, double jf, double vMax, double vMin, double aMax, double aMin, double jMax) {
+        if (std::abs(jf) >= std::abs(jMax) + j_eps || profile.t_sum.back() > t_max) {
+            return false;
+        }
+
+        t = profile.t;
+        t_sum = profile.t_sum;
+        for (size_t i = 0; i < 7; ++i) {
+            j[i] = factor * profile.j[i];
+            a[i+1] = factor * profile.a[i+1];
+            v[i+1] = factor * profile.v[i+1];
+            p[i+1] = p[0] + factor * (profile.p[i+1] - profile.p[0]);
+        }
+
+        direction = (vMax > 0) ? Profile::Direction::UP : Profile::Direction::DOWN;
+        const double vUppLim = (direction == Profile::Direction::UP ? vMax : vMin) + v_eps;
+        const double vLowLim = (direction == Profile::Direction::UP ? vMin : vMax) - v_eps;
+
+        for (size_t i = 2; i < 7; ++i) {
+            if (a[i+1] * a[i] < -std::numeric_limits<double>::epsilon()) {
+                const double v_a_zero = v[i] - (a[i] * a[i]) / (2 * j[i]);
+                if (v_a_zero > vUppLim || v_a_zero < vLowLim) {
+                    return false;
+                }
+            }
+        }
+
+        control_signs = profile.control_signs;
+
+        const double aUppLim = (direction == Profile::Direction::UP ? aMax : aMin) + a_eps;
+        const double aLowLim = (direction == Profile::Direction::UP ? aMin : aMax) - a_eps;
+
+        return std::abs(p.back() - pf) < p_precision && std::abs(v.back() - vf) < v_precision && std::abs(a.back() - af) < a_precision
+            && a[1] >= aLowLim && a[3] >= aLowLim && a[5] >= aLowLim
+            && a[1] <= aUppLim && a[3] <= aUppLim && a[5] <= aUppLim
+            && v[3] <= vUppLim && v[4] <= vUppLim && v[5] <= vUppLim && v[6] <= vUppLim
+            && v[3] >= vLowLim && v[4] >= vLowLim && v[5] >= vLowLim && v[6] >= vLowLim;
+    }
+
     inline void set_boundary(const Profile& profile) {
         a[0] = profile.a[0];
         v[0] = profile.v[0];
@@ -300,6 +358,14 @@ public:
         pf = pf_new;
     }
 
+    //! Keep the current state of a disabled DoF
+    inline void set_disabled(double p0_new, double v0_new, double a0_new) {
+        p.back() = p0_new;
+        v.back() = v0_new;
+        a.back() = a0_new;
+        t_sum.back() = 0.0;
+    }
+
 
     // For second-order position interface
     template<ControlSigns control_signs, ReachedLimits limits>
@@ -438,17 +504,38 @@ public:
         }
     }
 
-    Bound get_position_extrema() const {
-        Bound extrema;
-        extrema.min = std::numeric_limits<double>::infinity();
-        extrema.max = -std::numeric_limits<double>::infinity();
+    static void check_value_for_extremum(double t_ext, double value, Bound& ext) {
+        if (value < ext.min) {
+            ext.min = value;
+            ext.t_min = t_ext;
+        }
+        if (value > ext.max) {
+            ext.max = value;
+            ext.t_max = t_ext;
+        }
+    }
+
+    static void check_step_for_velocity_extremum(double t_sum, double t, double v, double a, double j, Bound& ext) {
+        check_value_for_extremum(t_sum, v, ext);
+
+        // The velocity has a single extremum where the acceleration crosses zero
+        if (j != 0) {
+            const double t_ext = -a / j;
+            if (0 < t_ext && t_ext < t) {
+                check_value_for_extremum(t_sum + t_ext, v - a * a / (2 * j), ext);
+            }
+        }
+    }
 
+    //! Call the function with the start time, duration, and initial state of each constant-jerk phase, including the brake pre-trajectory
+    template<class Func>
+    void for_each_phase(Func&& func) const {
         if (brake.duration > 0.0) {
             if (brake.t[0] > 0.0) {
-                check_step_for_position_extremum(0.0, brake.t[0], brake.p[0], brake.v[0], brake.a[0], brake.j[0], extrema);
+                func(0.0, brake.t[0], brake.p[0], brake.v[0], brake.a[0], brake.j[0]);
 
                 if (brake.t[1] > 0.0) {
-                    check_step_for_position_extremum(brake.t[0], brake.t[1], brake.p[1], brake.v[1], brake.a[1], brake.j[1], extrema);
+                    func(brake.t[0], brake.t[1], brake.p[1], brake.v[1], brake.a[1], brake.j[1]);
                 }
             }
         }
@@ -458,18 +545,65 @@ public:
             if (i > 0) {
                 t_current_sum = t_sum[i - 1];
             }
-            check_step_for_position_extremum(t_current_sum + brake.duration, t[i], p[i], v[i], a[i], j[i], extrema);
+            func(t_current_sum + brake.duration, t[i], p[i], v[i], a[i], j[i]);
         }
+    }
 
-        if (pf < extrema.min) {
-            extrema.min = pf;
-            extrema.t_min = t_sum.back() + brake.duration;
-        }
-        if (pf > extrema.max) {
-            extrema.max = pf;
-            extrema.t_max = t_sum.back() + brake.duration;
-        }
+    Bound get_position_extrema() const {
+        Bound extrema;
+        extrema.min = std::numeric_limits<double>::infinity();
+        extrema.max = -std::numeric_limits<double>::infinity();
 
+        for_each_phase([&extrema](double t_start, double t, double p, double v, double a, double j) {
+            check_step_for_position_extremum(t_start, t, p, v, a, j, extrema);
+        });
+
+        check_value_for_extremum(t_sum.back() + brake.duration, pf, extrema);
+        return extrema;
+    }
+
+    Bound get_velocity_extrema() const {
+        Bound extrema;
+        extrema.min = std::numeric_limits<double>::infinity();
+        extrema.max = -std::numeric_limits<double>::infinity();
+
+        for_each_phase([&extrema](double t_start, double t, double, double v, double a, double j) {
+            check_step_for_velocity_extremum(t_start, t, v, a, j, extrema);
+        });
+
+        check_value_for_extremum(t_sum.back() + brake.duration, vf, extrema);
+        return extrema;
+    }
+
+    Bound get_acceleration_extrema() const {
+        Bound extrema;
+        extrema.min = std::numeric_limits<double>::infinity();
+        extrema.max = -std::numeric_limits<double>::infinity();
+
+        // The acceleration is piecewise linear, so that its extrema are at the phase boundaries
+        for_each_phase([&extrema](double t_start, double, double, double, double a, double) {
+            check_value_for_extremum(t_start, a, extrema);
+        });
+
+        check_value_for_extremum(t_sum.back() + brake.duration, af, extrema);
+        return extrema;
+    }
+
+    Bound get_jerk_extrema() const {
+        Bound extrema;
+        extrema.min = std::numeric_limits<double>::infinity();
+        extrema.max = -std::numeric_limits<double>::infinity();
+
+        for_each_phase([&extrema](double t_start, double t, double, double, double, double j) {
+            if (t > 0.0) {
+                check_value_for_extremum(t_start, j, extrema);
+            }
+        });
+
+        // A profile without any duration has no jerk
+        if (extrema.min > extrema.max) {
+            extrema = {0.0, 0.0, 0.0, 0.0};
+        }
         return extrema;
     }
 
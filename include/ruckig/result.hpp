@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+
 
 namespace ruckig {
 
@@ -17,4 +22,72 @@ enum Result {
     ErrorSynchronizationCalculation = -111, ///< Error during the synchronization calculation (Step 2)
 };
 
+
+//! Stage of the trajectory calculation
+enum class CalculationStage {
+    None,
+    Validation, ///< Validation of the input
+    Step1, ///< Calculation of the extremal profiles and blocked intervals of each DoF
+    Synchronization, ///< Calculation of the synchronized duration
+    TimeSynchronization, ///< Calculation of the profiles for a given duration (Step 2)
+    Continuation, ///< Continuation of an interrupted calculation
+};
+
+
+//! @brief Structured information about an error of the trajectory calculation
+//!
+//! The record is filled without any memory allocation or string formatting, so that it can be read on the real-time
+//! path. Formatting is deferred to the consumer via to_string().
+struct CalculationError {
+    //! Result of the calculation, Working if there was no error
+    Result result {Result::Working};
+
+    //! Stage in which the error occurred
+    CalculationStage stage {CalculationStage::None};
+
+    //! DoF that caused the error, if it can be attributed to a single DoF
+    std::optional<size_t> dof;
+
+    //! Duration of the trajectory when the error occurred (e.g. the one that could not be synchronized to), NaN if unknown
+    double duration {std::numeric_limits<double>::quiet_NaN()};
+
+    bool has_error() const {
+        return result != Result::Working && result != Result::Finished;
+    }
+
+    std::string to_string() const {
+        if (!has_error()) {
+            return "no error";
+        }
+
+        std::string message;
+        switch (result) {
+            case Result::ErrorInvalidInput: message = "invalid input"; break;
+            case Result::ErrorTrajectoryDuration: message = "trajectory duration exceeds its numerical limits"; break;
+            case Result::ErrorPositionalLimits: message = "trajectory exceeds the positional limits"; break;
+            case Result::ErrorZeroLimits: message = "zero limits conflict"; break;
+            case Result::ErrorExecutionTimeCalculation: message = "error in step 1"; break;
+            case Result::ErrorSynchronizationCalculation: message = "error in step 2"; break;
+            default: message = "error"; break;
+        }
+
+        switch (stage) {
+            case CalculationStage::None: break;
+            case CalculationStage::Validation: message += " during validation"; break;
+            case CalculationStage::Step1: message += " during step 1"; break;
+            case CalculationStage::Synchronization: message += " during synchronization"; break;
+            case CalculationStage::TimeSynchronization: message += " during time synchronization"; break;
+            case CalculationStage::Continuation: message += " during continuation"; break;
+        }
+
+        if (dof) {
+            message += ", dof: " + std::to_string(*dof);
+        }
+        if (!std::isnan(duration)) {
+            message += ", duration: " + std::to_string(duration);
+        }
+        return message;
+    }
+};
+
 }
@@ -41,6 +41,12 @@ public:
         data[size] = value;
         ++size;
     }
+
+    // Copy the unsorted elements into a fixed array, and return their number
+    size_t copy_unsorted(Container& elements) const {
+        elements = data;
+        return size;
+    }
 };
 
 
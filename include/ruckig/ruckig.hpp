@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <iterator>
 #include <iostream>
 #include <limits>
 #include <math.h>
@@ -28,6 +29,71 @@ class Ruckig {
     //! Flag that indicates if the current_input was properly initialized
     bool current_input_initialized {false};
 
+    //! Input with the limits of the last successful validation, so that unchanged limits are not validated again
+    InputParameter<DOFs, CustomVector> validated_limits;
+    bool validated_limits_initialized {false};
+
+    //! Validate the settings of the input that depend on the Ruckig instance
+    template<bool throw_validation_error>
+    bool validate_configuration(const InputParameter<DOFs, CustomVector>& input) const {
+        if (!input.intermediate_positions.empty() && input.control_interface == ControlInterface::Position) {
+            if (input.intermediate_positions.size() > max_number_of_waypoints) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError("The number of intermediate positions " + std::to_string(input.intermediate_positions.size()) + " exceeds the maximum number of waypoints " + std::to_string(max_number_of_waypoints) + ".");
+                }
+                return false;
+            }
+        }
+
+        if (delta_time <= 0.0 && input.duration_discretization != DurationDiscretization::Continuous) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("delta time (control rate) parameter " + std::to_string(delta_time) + " should be larger than zero.");
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    //! @brief Is there a point on the line from start to end that holds the threshold distance to the current position for each DoF?
+    //!
+    //! The parameter of the point on the line is bounded by a fraction for each DoF, which are compared by cross
+    //! multiplication to avoid any division.
+    template<class V>
+    bool is_within_line_threshold(const V& pos_start, const V& pos_end, const V& pos_current, const V& threshold_distance) const {
+        double t_start_max_num {0.0}, t_start_max_den {1.0};
+        double t_end_min_num {1.0}, t_end_min_den {1.0};
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            const double distance = pos_end[dof] - pos_start[dof];
+            const double offset = pos_current[dof] - pos_start[dof];
+            if (distance == 0.0) {
+                if (std::abs(offset) > threshold_distance[dof]) {
+                    return false;
+                }
+                continue;
+            }
+
+            const double den = std::abs(distance);
+            const double h0_num = (distance > 0.0) ? offset : -offset;
+            const double t_start_num = h0_num - threshold_distance[dof];
+            const double t_end_num = h0_num + threshold_distance[dof];
+
+            if (t_start_num * t_start_max_den > t_start_max_num * den) {
+                t_start_max_num = t_start_num;
+                t_start_max_den = den;
+            }
+            if (t_end_num * t_end_min_den < t_end_min_num * den) {
+                t_end_min_num = t_end_num;
+                t_end_min_den = den;
+            }
+
+            if (t_start_max_num * t_end_min_den > t_end_min_num * t_start_max_den) {
+                return false;
+            }
+        }
+        return true;
+    }
+
 public:
     //! Calculator for new trajectories
     Calculator<DOFs, CustomVector> calculator;
@@ -72,6 +138,7 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs):
         current_input(InputParameter<DOFs, CustomVector>(dofs)),
+        validated_limits(InputParameter<DOFs, CustomVector>(dofs)),
         calculator(Calculator<DOFs, CustomVector>(dofs)),
         max_number_of_waypoints(0),
         degrees_of_freedom(dofs),
@@ -82,6 +149,7 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs, double delta_time):
         current_input(InputParameter<DOFs, CustomVector>(dofs)),
+        validated_limits(InputParameter<DOFs, CustomVector>(dofs)),
         calculator(Calculator<DOFs, CustomVector>(dofs)),
         max_number_of_waypoints(0),
         degrees_of_freedom(dofs),
@@ -93,6 +161,7 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs, double delta_time, size_t max_number_of_waypoints):
         current_input(InputParameter<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
+        validated_limits(InputParameter<DOFs, CustomVector>(dofs)),
         calculator(Calculator<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
         max_number_of_waypoints(max_number_of_waypoints),
         degrees_of_freedom(dofs),
@@ -109,107 +178,88 @@ public:
     //! Filter intermediate positions based on a threshold distance for each DoF
     template<class T> using Vector = CustomVector<T, DOFs>;
     std::vector<Vector<double>> filter_intermediate_positions(const InputParameter<DOFs, CustomVector>& input, const Vector<double>& threshold_distance) const {
-        if (input.intermediate_positions.empty()) {
-            return input.intermediate_positions;
-        }
+        std::vector<Vector<double>> filtered_positions;
+        filtered_positions.reserve(input.intermediate_positions.size());
+        filter_intermediate_positions(input, threshold_distance, std::back_inserter(filtered_positions));
+        return filtered_positions;
+    }
 
+    //! @brief Filter intermediate positions based on a threshold distance for each DoF, and write them to the output iterator
+    //!
+    //! An intermediate position is removed if all positions since the last kept one lie within the threshold distance
+    //! of the line to the next position. Zero-length segments of a DoF only require the distance to the start to hold
+    //! the threshold. This does not allocate memory, and returns the output iterator past the last written position.
+    template<class OutputIterator>
+    OutputIterator filter_intermediate_positions(const InputParameter<DOFs, CustomVector>& input, const Vector<double>& threshold_distance, OutputIterator filtered_positions) const {
         const size_t n_waypoints = input.intermediate_positions.size();
-        std::vector<bool> is_active;
-        is_active.resize(n_waypoints);
-        for (size_t i = 0; i < n_waypoints; ++i) {
-            is_active[i] = true;
-        }
 
         size_t start = 0;
-        size_t end = start + 2;
-        for (; end < n_waypoints + 2; ++end) {
-            const auto pos_start = (start == 0) ? input.current_position : input.intermediate_positions[start - 1];
-            const auto pos_end = (end == n_waypoints + 1) ? input.target_position : input.intermediate_positions[end - 1];
+        for (size_t end = start + 2; end < n_waypoints + 2; ++end) {
+            const auto& pos_start = (start == 0) ? input.current_position : input.intermediate_positions[start - 1];
+            const auto& pos_end = (end == n_waypoints + 1) ? input.target_position : input.intermediate_positions[end - 1];
 
-            // Check for all intermediate positions
+            // Check all intermediate positions, starting with the most recent one as it is the most likely to fail
             bool are_all_below {true};
-            for (size_t current = start + 1; current < end; ++current) {
-                const auto pos_current = input.intermediate_positions[current - 1];
-
-                // Is there a point t on the line that holds the threshold?
-                double t_start_max = 0.0;
-                double t_end_min = 1.0;
-                for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                    const double h0 = (pos_current[dof] - pos_start[dof]) / (pos_end[dof] - pos_start[dof]);
-                    const double t_start = h0 - threshold_distance[dof] / std::abs(pos_end[dof] - pos_start[dof]);
-                    const double t_end = h0 + threshold_distance[dof] / std::abs(pos_end[dof] - pos_start[dof]);
-
-                    t_start_max = std::max(t_start, t_start_max);
-                    t_end_min = std::min(t_end, t_end_min);
-
-                    if (t_start_max > t_end_min) {
-                        are_all_below = false;
-                        break;
-                    }
-                }
-                if (!are_all_below) {
-                    break;
-                }
+            for (size_t current = end - 1; current > start && are_all_below; --current) {
+                are_all_below = is_within_line_threshold(pos_start, pos_end, input.intermediate_positions[current - 1], threshold_distance);
             }
 
-            is_active[end - 2] = !are_all_below;
+            // The decision for the intermediate position before the end is final
             if (!are_all_below) {
+                *filtered_positions = input.intermediate_positions[end - 2];
+                ++filtered_positions;
                 start = end - 1;
             }
         }
 
-        std::vector<Vector<double>> filtered_positions;
-        filtered_positions.reserve(n_waypoints);
-        for (size_t i = 0; i < n_waypoints; ++i) {
-            if (is_active[i]) {
-                filtered_positions.push_back(input.intermediate_positions[i]);
-            }
-        }
-
         return filtered_positions;
     }
 
     //! Validate the input as well as the Ruckig instance for trajectory calculation
     template<bool throw_validation_error = true>
     bool validate_input(const InputParameter<DOFs, CustomVector>& input, bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
-        if (!input.template validate<throw_validation_error>(check_current_state_within_limits, check_target_state_within_limits)) {
-            return false;
-        }
-
-        if (!input.intermediate_positions.empty() && input.control_interface == ControlInterface::Position) {
-            if (input.intermediate_positions.size() > max_number_of_waypoints) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("The number of intermediate positions " + std::to_string(input.intermediate_positions.size()) + " exceeds the maximum number of waypoints " + std::to_string(max_number_of_waypoints) + ".");
-                }
-                return false;
-            }
-        }
-
-        if (delta_time <= 0.0 && input.duration_discretization != DurationDiscretization::Continuous) {
-            if constexpr (throw_validation_error) {
-                throw RuckigError("delta time (control rate) parameter " + std::to_string(delta_time) + " should be larger than zero.");
-            }
-            return false;
-        }
-
-        return true;
+        return input.template validate<throw_validation_error>(check_current_state_within_limits, check_target_state_within_limits)
+            && validate_configuration<throw_validation_error>(input);
     }
 
-    //! Calculate a new trajectory for the given input
+    //! Calculate a new trajectory for the given input, an interrupted calculation is continued until it is completed
     Result calculate(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory) {
         bool was_interrupted {false};
-        return calculate(input, trajectory, was_interrupted);
+        Result result = calculate(input, trajectory, was_interrupted);
+        while (result == Result::Working && was_interrupted) {
+            result = continue_calculation(input, trajectory, was_interrupted);
+        }
+        return result;
     }
 
     //! Calculate a new trajectory for the given input and check for interruption
     Result calculate(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory, bool& was_interrupted) {
-        if (!validate_input<throw_error>(input, false, true)) {
+        // Same as validate_input, but the limits are only validated if they changed since the last calculation
+        bool is_valid {true};
+        std::optional<size_t> invalid_dof;
+        if (!validated_limits_initialized || !input.has_equal_limits(validated_limits)) {
+            validated_limits_initialized = false;
+            is_valid = input.template validate_limits<throw_error>(invalid_dof);
+            if (is_valid) {
+                validated_limits.copy_limits_from(input);
+                validated_limits_initialized = true;
+            }
+        }
+
+        is_valid = is_valid && input.template validate_state<throw_error>(invalid_dof, false, true) && input.template validate_intermediate_positions<throw_error>() && validate_configuration<throw_error>(input);
+        if (!is_valid) {
+            calculator.error = {Result::ErrorInvalidInput, CalculationStage::Validation, invalid_dof, std::numeric_limits<double>::quiet_NaN()};
             return Result::ErrorInvalidInput;
         }
 
         return calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
     }
 
+    //! Continue an interrupted trajectory calculation for the same input
+    Result continue_calculation(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory, bool& was_interrupted) {
+        return calculator.template continue_calculation<throw_error>(input, trajectory, delta_time, was_interrupted);
+    }
+
     //! Get the next output state (with step delta_time) along the calculated trajectory for the given input
     Result update(const InputParameter<DOFs, CustomVector>& input, OutputParameter<DOFs, CustomVector>& output) {
         const auto start = std::chrono::steady_clock::now();
@@ -225,6 +275,11 @@ public:
         Result result {Result::Working};
         if (!current_input_initialized || input != current_input) {
             result = calculate(input, output.trajectory, output.was_calculation_interrupted);
+            // The trajectory is sampled right away, so an interrupted calculation needs to be finished within this cycle
+            while (result == Result::Working && output.was_calculation_interrupted) {
+                result = continue_calculation(input, output.trajectory, output.was_calculation_interrupted);
+            }
+            output.error = calculator.error;
             if (result != Result::Working && result != Result::ErrorPositionalLimits) {
                 return result;
             }
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include <ruckig/output_parameter.hpp>
+#include <ruckig/trajectory.hpp>
+#include <ruckig/trajectory_view.hpp>
+
+
+namespace ruckig {
+
+//! Kinematic state of a single control cycle with a fixed memory layout
+template<size_t DOFs>
+struct OutputSample {
+    double time;
+    uint64_t new_section;
+    std::array<double, DOFs> new_position, new_velocity, new_acceleration, new_jerk;
+};
+
+
+//! @brief Lock-free stream of output samples and trajectory snapshots for multi-process control stacks
+//!
+//! The class has a fixed memory layout without pointers, so that it can be placed in shared memory (e.g. created via
+//! shm_open and mmap). The output samples are passed through a single-producer/single-consumer ring buffer. In
+//! addition, the latest trajectory is published in the binary trajectory format and guarded by a seqlock, so that
+//! consumers can sample ahead without syscalls. Neither side ever blocks or allocates memory.
+template<size_t DOFs, size_t Capacity = 64, size_t MaxSections = 1>
+class SharedOutputStream {
+    static_assert(DOFs >= 1, "The shared output stream requires a fixed number of DoFs.");
+    static_assert(Capacity >= 1, "The capacity of the shared output stream needs to be at least one.");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "The shared output stream requires lock-free atomics.");
+
+    constexpr static size_t snapshot_capacity {sizeof(BinaryTrajectoryHeader) + MaxSections * DOFs * sizeof(Profile) + MaxSections * sizeof(double) + DOFs * sizeof(double)};
+
+    // Separate cache lines for the indices written by producer and consumer
+    alignas(64) std::atomic<uint64_t> head {0}; ///< Next sample to write, only modified by the producer
+    alignas(64) std::atomic<uint64_t> tail {0}; ///< Next sample to read, only modified by the consumer
+    alignas(64) std::array<OutputSample<DOFs>, Capacity> samples;
+
+    alignas(64) std::atomic<uint64_t> sequence {0}; ///< Odd while the snapshot is written
+    std::atomic<uint64_t> snapshot_size {0}; ///< Only written while the sequence is odd
+    alignas(64) unsigned char snapshot[snapshot_capacity];
+
+public:
+    //! Number of retries of a reader before giving up on a concurrently written snapshot
+    constexpr static size_t max_read_attempts {64};
+
+    SharedOutputStream() { }
+    SharedOutputStream(const SharedOutputStream&) = delete;
+    SharedOutputStream& operator=(const SharedOutputStream&) = delete;
+
+    //! Construct the stream within the given (64-byte aligned) memory of at least sizeof(SharedOutputStream) bytes
+    static SharedOutputStream* create(void* memory) {
+        return new (memory) SharedOutputStream();
+    }
+
+    //! Attach to a stream that was created by another process before
+    static SharedOutputStream* attach(void* memory) {
+        return std::launder(static_cast<SharedOutputStream*>(memory));
+    }
+
+    //! Push the current state of the output parameter (producer only). Returns false if the ring buffer is full.
+    template<template<class, size_t> class CustomVector>
+    bool push(const OutputParameter<DOFs, CustomVector>& output) {
+        const uint64_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head - tail.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+
+        OutputSample<DOFs>& sample = samples[current_head % Capacity];
+        sample.time = output.time;
+        sample.new_section = output.new_section;
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            sample.new_position[dof] = output.new_position[dof];
+            sample.new_velocity[dof] = output.new_velocity[dof];
+            sample.new_acceleration[dof] = output.new_acceleration[dof];
+            sample.new_jerk[dof] = output.new_jerk[dof];
+        }
+
+        head.store(current_head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Pop the oldest sample (consumer only). Returns false if the ring buffer is empty.
+    bool pop(OutputSample<DOFs>& sample) {
+        const uint64_t current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        sample = samples[current_tail % Capacity];
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Number of samples that are ready to be popped
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    //! Publish a snapshot of the trajectory (producer only). Returns false if the trajectory has more than MaxSections sections.
+    template<template<class, size_t> class CustomVector>
+    bool publish(const Trajectory<DOFs, CustomVector>& trajectory) {
+        const size_t size = TrajectoryView<DOFs, CustomVector>::get_binary_size(trajectory);
+        if (size > snapshot_capacity) {
+            return false;
+        }
+
+        const uint64_t current_sequence = sequence.load(std::memory_order_relaxed);
+        sequence.store(current_sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        snapshot_size.store(TrajectoryView<DOFs, CustomVector>::write(trajectory, snapshot, snapshot_capacity), std::memory_order_relaxed);
+
+        sequence.store(current_sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    //! @brief Call the function with a view of the latest trajectory snapshot (consumer only)
+    //!
+    //! The snapshot is copied onto the stack of the consumer (snapshot_capacity bytes), and the function is only called
+    //! once with a view of a copy that was not concurrently overwritten and passes the validation including the
+    //! checksum. Returns false if no snapshot was published yet or no consistent snapshot could be read.
+    template<class Func>
+    bool read(Func&& func) const {
+        alignas(64) unsigned char copy[snapshot_capacity];
+
+        for (size_t attempt = 0; attempt < max_read_attempts; ++attempt) {
+            const uint64_t sequence_before = sequence.load(std::memory_order_acquire);
+            if (sequence_before == 0) {
+                return false;
+            }
+            if (sequence_before % 2 == 1) {
+                continue;
+            }
+
+            const size_t size = std::min<uint64_t>(snapshot_size.load(std::memory_order_relaxed), snapshot_capacity);
+            std::memcpy(copy, snapshot, size);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != sequence_before) {
+                continue;
+            }
+
+            TrajectoryView<DOFs> view;
+            if (!view.template load<false>(copy, size)) {
+                return false;
+            }
+
+            func(static_cast<const TrajectoryView<DOFs>&>(view));
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace ruckig
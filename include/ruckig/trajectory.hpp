@@ -1,18 +1,71 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <ruckig/error.hpp>
 #include <ruckig/profile.hpp>
+#include <ruckig/roots.hpp>
+#include <ruckig/utils.hpp>
 
 
 namespace ruckig {
 
+template<size_t, template<class, size_t> class> class StopCalculator;
 template<size_t, template<class, size_t> class> class TargetCalculator;
 template<size_t, template<class, size_t> class> class WaypointsCalculator;
+template<size_t, template<class, size_t> class> class TrajectoryView;
+
+
+//! Extrema of the position, velocity, acceleration, and jerk of a single DoF
+struct KinematicBounds {
+    Bound position, velocity, acceleration, jerk;
+};
+
+
+//! A closed interval of time
+struct TimeInterval {
+    double start, end;
+};
+
+
+//! Thread-safe flag for data that is calculated lazily on the first access. Copies are invalid and recalculate their data.
+class LazyCalculation {
+    std::mutex mutex;
+    std::atomic<bool> is_valid {false};
+
+public:
+    LazyCalculation() { }
+    LazyCalculation(const LazyCalculation&) { }
+    LazyCalculation& operator=(const LazyCalculation&) {
+        invalidate();
+        return *this;
+    }
+
+    void invalidate() {
+        is_valid.store(false, std::memory_order_release);
+    }
+
+    //! Call the function if the data is invalid, so that concurrent callers wait for a single calculation
+    template<class Func>
+    void ensure(Func&& calculate) {
+        if (is_valid.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock {mutex};
+        if (!is_valid.load(std::memory_order_relaxed)) {
+            calculate();
+            is_valid.store(true, std::memory_order_release);
+        }
+    }
+};
 
 
 //! The trajectory generated by the Ruckig algorithm.
@@ -26,8 +79,10 @@ class Trajectory {
 
     template<class T> using Vector = CustomVector<T, DOFs>;
 
+    friend class StopCalculator<DOFs, CustomVector>;
     friend class TargetCalculator<DOFs, CustomVector>;
     friend class WaypointsCalculator<DOFs, CustomVector>;
+    friend class TrajectoryView<DOFs, CustomVector>;
 
     Container<Vector<Profile>> profiles;
 
@@ -35,10 +90,104 @@ class Trajectory {
     Container<double> cumulative_times;
 
     Vector<double> independent_min_durations;
-    Vector<Bound> position_extrema;
 
     size_t continue_calculation_counter {0};
 
+    //! Extrema of the overall trajectory and of each section, calculated lazily once per calculation
+    mutable Vector<KinematicBounds> extrema;
+    mutable Container<Vector<KinematicBounds>> section_extrema;
+    mutable LazyCalculation extrema_calculation;
+
+    //! Needs to be called whenever the profiles of the trajectory change
+    void invalidate_extrema() {
+        extrema_calculation.invalidate();
+    }
+
+    void calculate_extrema() const {
+#if defined WITH_CLOUD_CLIENT
+        section_extrema.resize(profiles.size());
+#endif
+        if constexpr (DOFs == 0) {
+            extrema.resize(degrees_of_freedom);
+            for (auto& e: section_extrema) {
+                e.resize(degrees_of_freedom);
+            }
+        }
+
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            const double t_section = (i > 0) ? cumulative_times[i - 1] : 0.0;
+
+            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+                const Profile& p = profiles[i][dof];
+                KinematicBounds& bounds = section_extrema[i][dof];
+                bounds.position = p.get_position_extrema();
+                bounds.velocity = p.get_velocity_extrema();
+                bounds.acceleration = p.get_acceleration_extrema();
+                bounds.jerk = p.get_jerk_extrema();
+
+                // Times of the profiles are relative to the start of their section
+                for (Bound* b: {&bounds.position, &bounds.velocity, &bounds.acceleration, &bounds.jerk}) {
+                    b->t_min += t_section;
+                    b->t_max += t_section;
+                }
+
+                if (i == 0) {
+                    extrema[dof] = bounds;
+                    continue;
+                }
+
+                merge_bound(bounds.position, extrema[dof].position);
+                merge_bound(bounds.velocity, extrema[dof].velocity);
+                merge_bound(bounds.acceleration, extrema[dof].acceleration);
+                merge_bound(bounds.jerk, extrema[dof].jerk);
+            }
+        }
+    }
+
+    //! Call the function with the start time (relative to the trajectory), duration, and initial state of each constant-jerk phase of a DoF
+    template<class Func>
+    void for_each_phase(size_t dof, Func&& func) const {
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            const double t_section = (i > 0) ? cumulative_times[i - 1] : 0.0;
+            const Profile& profile = profiles[i][dof];
+            profile.for_each_phase([&](double t_start, double t, double p, double v, double a, double j) {
+                func(t_section + t_start, t, p, v, a, j);
+            });
+
+            // Non-time synchronization: Keep constant acceleration until the end of the section
+            const double t_profile = profile.brake.duration + profile.t_sum.back();
+            const double t_remaining = cumulative_times[i] - t_section - t_profile;
+            if (t_remaining > 0.0) {
+                func(t_section + t_profile, t_remaining, profile.pf, profile.vf, profile.af, 0.0);
+            }
+        }
+    }
+
+    static void merge_bound(const Bound& section_bound, Bound& bound) {
+        if (section_bound.max > bound.max) {
+            bound.max = section_bound.max;
+            bound.t_max = section_bound.t_max;
+        }
+        if (section_bound.min < bound.min) {
+            bound.min = section_bound.min;
+            bound.t_min = section_bound.t_min;
+        }
+    }
+
+    template<class Member>
+    Vector<Bound> get_extrema_of(Member member) const {
+        extrema_calculation.ensure([this]{ calculate_extrema(); });
+
+        Vector<Bound> result;
+        if constexpr (DOFs == 0) {
+            result.resize(degrees_of_freedom);
+        }
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            result[dof] = extrema[dof].*member;
+        }
+        return result;
+    }
+
 #if defined WITH_CLOUD_CLIENT
     template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
     void resize(size_t max_number_of_waypoints) {
@@ -59,27 +208,35 @@ class Trajectory {
     //! Calculates the base values to then integrate from
     template<typename Func>
     void state_to_integrate_from(double time, size_t& new_section, Func&& set_integrate) const {
+        state_to_integrate_from(time, duration, cumulative_times.data(), profiles.size(), degrees_of_freedom, [this](size_t section, size_t dof) -> decltype(auto) {
+            return profiles[section][dof];
+        }, new_section, std::forward<Func>(set_integrate));
+    }
+
+    //! Calculates the base values to then integrate from, independent of the underlying storage of the profiles
+    template<typename GetProfile, typename Func>
+    static void state_to_integrate_from(double time, double duration, const double* cumulative_times, size_t number_of_sections, size_t degrees_of_freedom, GetProfile&& get_profile, size_t& new_section, Func&& set_integrate) {
         if (time >= duration) {
             // Keep constant acceleration
-            new_section = profiles.size();
-            const auto& profiles_dof = profiles.back();
+            new_section = number_of_sections;
             for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                const double t_pre = (profiles.size() > 1) ? cumulative_times[cumulative_times.size() - 2] : profiles_dof[dof].brake.duration;
-                const double t_diff = time - (t_pre + profiles_dof[dof].t_sum.back());
-                set_integrate(dof, t_diff, profiles_dof[dof].p.back(), profiles_dof[dof].v.back(), profiles_dof[dof].a.back(), 0.0);
+                const auto& p = get_profile(number_of_sections - 1, dof);
+                const double t_pre = (number_of_sections > 1) ? cumulative_times[number_of_sections - 2] : p.brake.duration;
+                const double t_diff = time - (t_pre + p.t_sum.back());
+                set_integrate(dof, t_diff, p.p.back(), p.v.back(), p.a.back(), 0.0);
             }
             return;
         }
 
-        const auto new_section_ptr = std::upper_bound(cumulative_times.begin(), cumulative_times.end(), time);
-        new_section = std::distance(cumulative_times.begin(), new_section_ptr);
+        const auto new_section_ptr = std::upper_bound(cumulative_times, cumulative_times + number_of_sections, time);
+        new_section = std::distance(cumulative_times, new_section_ptr);
         double t_diff = time;
         if (new_section > 0) {
             t_diff -= cumulative_times[new_section - 1];
         }
 
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            const Profile& p = profiles[new_section][dof];
+            const auto& p = get_profile(new_section, dof);
             double t_diff_dof = t_diff;
 
             // Brake pre-trajectory
@@ -156,7 +313,7 @@ public:
 
         profiles[0].resize(dofs);
         independent_min_durations.resize(dofs);
-        position_extrema.resize(dofs);
+        extrema.resize(dofs);
     }
 
 #if defined WITH_CLOUD_CLIENT
@@ -170,7 +327,7 @@ public:
         resize(max_number_of_waypoints);
 
         independent_min_durations.resize(dofs);
-        position_extrema.resize(dofs);
+        extrema.resize(dofs);
     }
 #endif
 
@@ -244,6 +401,19 @@ public:
         });
     }
 
+    //! @brief Sample the kinematic state at the n equidistant times t0 + i * dt into a flat buffer
+    //!
+    //! The buffer needs to hold 3 * n * degrees_of_freedom values, and is filled with the position, velocity, and
+    //! acceleration of one sample after another. This does not allocate any memory.
+    void sample_into(double* new_states, double t0, double dt, size_t n) const {
+        size_t new_section;
+        for (size_t i = 0; i < n; ++i) {
+            double* state = new_states + 3 * i * degrees_of_freedom;
+            state_to_integrate_from(t0 + i * dt, new_section, [&](size_t dof, double t, double p, double v, double a, double j) {
+                std::tie(state[dof], state[degrees_of_freedom + dof], state[2 * degrees_of_freedom + dof]) = integrate(t, p, v, a, j);
+            });
+        }
+    }
 
     //! Get the underlying profiles of the trajectory (only in the Ruckig Community Version)
     Container<Vector<Profile>> get_profiles() const {
@@ -265,27 +435,203 @@ public:
         return independent_min_durations;
     }
 
-    //! Get the min/max values of the position for each DoF
-    Vector<Bound> get_position_extrema() {
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            position_extrema[dof] = profiles[0][dof].get_position_extrema();
+    //! @brief Get the min/max values of the position for each DoF
+    //!
+    //! The first access of any extrema after a calculation computes the extrema of all kinematic values and sections on
+    //! the calling thread. As it locks a mutex and might allocate memory (for dynamic DoFs or with the cloud client), this
+    //! first access is not real-time safe. Subsequent accesses only copy the cached extrema.
+    Vector<Bound> get_position_extrema() const {
+        return get_extrema_of(&KinematicBounds::position);
+    }
+
+    //! Get the min/max values of the velocity for each DoF. The first access is not real-time safe, see get_position_extrema.
+    Vector<Bound> get_velocity_extrema() const {
+        return get_extrema_of(&KinematicBounds::velocity);
+    }
+
+    //! Get the min/max values of the acceleration for each DoF. The first access is not real-time safe, see get_position_extrema.
+    Vector<Bound> get_acceleration_extrema() const {
+        return get_extrema_of(&KinematicBounds::acceleration);
+    }
+
+    //! Get the min/max values of the jerk for each DoF. The first access is not real-time safe, see get_position_extrema.
+    Vector<Bound> get_jerk_extrema() const {
+        return get_extrema_of(&KinematicBounds::jerk);
+    }
+
+    //! @brief Get the extrema of all kinematic values for each DoF within the given section
+    //!
+    //! The extrema are calculated analytically on the first access after each calculation (which is not real-time safe,
+    //! see get_position_extrema) and are cached afterwards. Their times are relative to the start of the trajectory.
+    Vector<KinematicBounds> get_section_extrema(size_t section) const {
+        extrema_calculation.ensure([this]{ calculate_extrema(); });
+        return section_extrema[section];
+    }
+
+    //! @brief Get all time intervals in which the position of the DoF lies within the given range
+    //!
+    //! The crossings of the range are calculated analytically for each constant-jerk phase. Only intervals of a
+    //! non-zero duration are returned (except for a trajectory of zero duration), sorted and without overlap.
+    std::vector<TimeInterval> get_time_intervals_within_position(size_t dof, double min_position, double max_position) const {
+        std::vector<TimeInterval> intervals;
+        if (dof >= degrees_of_freedom || min_position > max_position) {
+            return intervals;
         }
 
-        for (size_t i = 1; i < profiles.size(); ++i) {
-            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                auto section_position_extrema = profiles[i][dof].get_position_extrema();
-                if (section_position_extrema.max > position_extrema[dof].max) {
-                    position_extrema[dof].max = section_position_extrema.max;
-                    position_extrema[dof].t_max = section_position_extrema.t_max;
+        if (duration <= 0.0) {
+            const double p0 = profiles[0][dof].p[0];
+            if (min_position <= p0 && p0 <= max_position) {
+                intervals.push_back({0.0, 0.0});
+            }
+            return intervals;
+        }
+
+        bool was_within {false};
+        for_each_phase(dof, [&](double t_start, double t, double p, double v, double a, double j) {
+            if (t <= 0.0) {
+                return;
+            }
+
+            // Split the phase at all crossings of the range boundaries (at most six), and check the position in between
+            std::array<double, 8> splits;
+            size_t number_of_splits {1};
+            splits[0] = 0.0;
+            std::array<double, 3> t_roots;
+            for (const double position: {min_position, max_position}) {
+                // The splits are sorted below, so skip the sorting of the roots
+                const size_t number_of_roots = roots::solve_cubic(j/6, a/2, v, p - position).copy_unsorted(t_roots);
+                for (size_t r = 0; r < number_of_roots; ++r) {
+                    const double t_root = t_roots[r];
+                    if (0.0 < t_root && t_root < t) {
+                        // Insert sorted, the first split at zero is always smaller
+                        size_t i = number_of_splits;
+                        for (; splits[i - 1] > t_root; --i) {
+                            splits[i] = splits[i - 1];
+                        }
+                        splits[i] = t_root;
+                        number_of_splits += 1;
+                    }
                 }
-                if (section_position_extrema.min < position_extrema[dof].min) {
-                    position_extrema[dof].min = section_position_extrema.min;
-                    position_extrema[dof].t_min = section_position_extrema.t_min;
+            }
+            splits[number_of_splits++] = t;
+
+            for (size_t i = 0; i + 1 < number_of_splits; ++i) {
+                if (splits[i + 1] <= splits[i]) {
+                    continue;
+                }
+
+                const double p_mid = std::get<0>(integrate((splits[i] + splits[i + 1]) / 2, p, v, a, j));
+                const bool is_within = (min_position <= p_mid && p_mid <= max_position);
+                if (is_within && was_within) {
+                    intervals.back().end = t_start + splits[i + 1];
+                } else if (is_within) {
+                    intervals.push_back({t_start + splits[i], t_start + splits[i + 1]});
                 }
+                was_within = is_within;
             }
+        });
+        return intervals;
+    }
+
+    //! Get all time intervals in which the positions of all DoFs lie within the given axis-aligned box
+    std::vector<TimeInterval> get_time_intervals_within_box(const Vector<double>& min_position, const Vector<double>& max_position) const {
+        std::vector<TimeInterval> intervals = get_time_intervals_within_position(0, min_position[0], max_position[0]);
+        std::vector<TimeInterval> dof_intervals, intersection;
+        for (size_t dof = 1; dof < degrees_of_freedom && !intervals.empty(); ++dof) {
+            dof_intervals = get_time_intervals_within_position(dof, min_position[dof], max_position[dof]);
+
+            // Intersect two sorted lists of disjoint intervals
+            intersection.clear();
+            auto it = intervals.begin();
+            auto dof_it = dof_intervals.begin();
+            while (it != intervals.end() && dof_it != dof_intervals.end()) {
+                const double start = std::max(it->start, dof_it->start);
+                const double end = std::min(it->end, dof_it->end);
+                if (start < end || (start == end && duration <= 0.0)) {
+                    intersection.push_back({start, end});
+                }
+
+                if (it->end < dof_it->end) {
+                    ++it;
+                } else {
+                    ++dof_it;
+                }
+            }
+            std::swap(intervals, intersection);
         }
+        return intervals;
+    }
+
+    //! @brief Get tight bounds of the position of each DoF for each time slice of the given partition
+    //!
+    //! The partition is a sorted list of times, so that slice k spans from time_partition[k] to time_partition[k+1].
+    //! The bounds are calculated analytically from the extrema of each constant-jerk phase within the slice, and are
+    //! suitable as swept boxes for broad-phase collision checking. Times are clamped to the duration of the trajectory.
+    std::vector<Vector<Bound>> get_swept_position_bounds(const std::vector<double>& time_partition) const {
+        const size_t number_of_slices = (time_partition.size() > 1) ? time_partition.size() - 1 : 0;
+
+        Vector<Bound> empty_bounds;
+        if constexpr (DOFs == 0) {
+            empty_bounds.resize(degrees_of_freedom);
+        }
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            empty_bounds[dof] = {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0.0, 0.0};
+        }
+        std::vector<Vector<Bound>> bounds(number_of_slices, empty_bounds);
+        if (number_of_slices == 0) {
+            return bounds;
+        }
+
+        const auto clamp_time = [this](double time) { return std::clamp(time, 0.0, duration); };
+
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            // Sweep over the phases and slices, which are both sorted by time
+            size_t first_slice {0};
+            for_each_phase(dof, [&](double t_start, double t, double p, double v, double a, double j) {
+                const double t_end = t_start + t;
+                while (first_slice + 1 < number_of_slices && clamp_time(time_partition[first_slice + 1]) < t_start) {
+                    ++first_slice;
+                }
+
+                for (size_t k = first_slice; k < number_of_slices && clamp_time(time_partition[k]) <= t_end; ++k) {
+                    const double slice_end = clamp_time(time_partition[k + 1]);
+                    if (slice_end < t_start) {
+                        continue;
+                    }
+
+                    const double t_local_start = std::max(clamp_time(time_partition[k]) - t_start, 0.0);
+                    const double t_local_end = std::min(slice_end - t_start, t);
+
+                    auto [p_start, v_start, a_start] = integrate(t_local_start, p, v, a, j);
+                    Profile::check_step_for_position_extremum(t_start + t_local_start, t_local_end - t_local_start, p_start, v_start, a_start, j, bounds[k][dof]);
+                    Profile::check_value_for_extremum(t_start + t_local_end, std::get<0>(integrate(t_local_end, p, v, a, j)), bounds[k][dof]);
+                }
+            });
+        }
+        return bounds;
+    }
+
+    //! Get tight bounds of the position of each DoF for each time slice between two consecutive phase switches of any DoF
+    std::vector<Vector<Bound>> get_swept_position_bounds() const {
+        std::vector<double> time_partition {0.0};
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            for_each_phase(dof, [&time_partition](double t_start, double t, double, double, double, double) {
+                if (t > 0.0) {
+                    time_partition.push_back(t_start + t);
+                }
+            });
+        }
+        std::sort(time_partition.begin(), time_partition.end());
+        time_partition.erase(std::unique(time_partition.begin(), time_partition.end()), time_partition.end());
+        if (time_partition.size() == 1) {
+            time_partition.push_back(0.0);
+        }
+        return get_swept_position_bounds(time_partition);
+    }
 
-        return position_extrema;
+    //! Get tight bounds of the position of each DoF within the given time window
+    Vector<Bound> get_position_bounds(double t_start, double t_end) const {
+        return get_swept_position_bounds({t_start, t_end})[0];
     }
 
     //! Get the time that this trajectory passes a specific position of a given DoF the first time
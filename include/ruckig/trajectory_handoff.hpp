@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/output_parameter.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/ruckig.hpp>
+#include <ruckig/trajectory.hpp>
+
+
+namespace ruckig {
+
+//! @brief Lock-free handoff of trajectories from a planner thread to a real-time thread
+//!
+//! The planner side calculates new trajectories with `calculate` and publishes them into a triple buffer. The real-time
+//! side samples the newest trajectory with `update` once per control cycle, and picks up new trajectories only at a
+//! cycle boundary. Each trajectory starts at a given control cycle: The previous trajectory is continued until this
+//! cycle is reached, and the output time is rebased correctly if the trajectory is picked up after its start. The
+//! real-time side never blocks, allocates, or copies a trajectory. There must be only a single planner and a single
+//! real-time thread.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector, bool throw_error = false>
+class TrajectoryHandoff {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+
+    constexpr static uint64_t index_mask {0b011};
+    constexpr static uint64_t dirty_flag {0b100};
+    constexpr static size_t start_cycle_shift {3};
+
+    //! Trajectories of the triple buffer
+    std::array<Trajectory<DOFs, CustomVector>, 3> trajectories;
+
+    //! Index of the buffer that is currently exchanged, with a flag for a newly published trajectory and its start cycle in the upper bits
+    std::atomic<uint64_t> middle {2};
+
+    size_t back {0}; ///< Only accessed by the planner
+    size_t published {3}; ///< Last published buffer, only accessed by the planner
+    uint64_t published_start_cycle {0}; ///< Only accessed by the planner
+
+    size_t front {1}; ///< Only accessed by the real-time thread
+    uint64_t front_start_cycle {0}; ///< Only accessed by the real-time thread
+    bool has_trajectory {false}; ///< Only accessed by the real-time thread
+
+    //! Number of control cycles (update calls) of the real-time thread
+    std::atomic<uint64_t> cycle {0};
+
+public:
+    //! Calculator of the planner
+    Ruckig<DOFs, CustomVector, throw_error> otg;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TrajectoryHandoff(double delta_time): otg(delta_time) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TrajectoryHandoff(size_t dofs, double delta_time):
+        trajectories({Trajectory<DOFs, CustomVector>(dofs), Trajectory<DOFs, CustomVector>(dofs), Trajectory<DOFs, CustomVector>(dofs)}),
+        otg(dofs, delta_time) { }
+
+    //! Get the number of control cycles that were executed by the real-time thread
+    uint64_t get_cycle() const {
+        return cycle.load(std::memory_order_acquire);
+    }
+
+    //! @brief Get the kinematic state of the last published trajectory at the given control cycle (planner only)
+    //!
+    //! This is useful for replanning from a future cycle that the real-time thread has not yet reached. Returns false if
+    //! no trajectory was published yet, or if the cycle is before the start cycle of the published trajectory.
+    bool at_cycle(uint64_t start_cycle, Vector<double>& new_position, Vector<double>& new_velocity, Vector<double>& new_acceleration) const {
+        if (published > 2 || start_cycle < published_start_cycle) {
+            return false;
+        }
+
+        // The published trajectory is never written to until it is returned to the planner again
+        const double time = (static_cast<double>(start_cycle) - static_cast<double>(published_start_cycle)) * otg.delta_time;
+        trajectories[published].at_time(time, new_position, new_velocity, new_acceleration);
+        return true;
+    }
+
+    //! Calculate a new trajectory that starts at the given control cycle and publish it to the real-time thread (planner only)
+    Result calculate(const InputParameter<DOFs, CustomVector>& input, uint64_t start_cycle) {
+        const Result result = otg.calculate(input, trajectories[back]);
+        if (result != Result::Working && result != Result::ErrorPositionalLimits) {
+            return result;
+        }
+
+        published = back;
+        published_start_cycle = start_cycle;
+        back = middle.exchange((start_cycle << start_cycle_shift) | dirty_flag | back, std::memory_order_acq_rel) & index_mask;
+        return result;
+    }
+
+    //! Get the next output state along the newest trajectory (real-time thread only)
+    Result update(OutputParameter<DOFs, CustomVector>& output) {
+        const uint64_t current_cycle = cycle.load(std::memory_order_relaxed) + 1;
+        cycle.store(current_cycle, std::memory_order_release);
+
+        output.new_calculation = false;
+        // Pick up a new trajectory once its start cycle is reached. If the planner publishes concurrently, the exchange
+        // fails and is retried in the next cycle.
+        uint64_t current_middle = middle.load(std::memory_order_relaxed);
+        if ((current_middle & dirty_flag) && (current_middle >> start_cycle_shift) <= current_cycle) {
+            if (middle.compare_exchange_strong(current_middle, front, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                front = current_middle & index_mask;
+                front_start_cycle = current_middle >> start_cycle_shift;
+                has_trajectory = true;
+                output.new_calculation = true;
+            }
+        }
+
+        if (!has_trajectory) {
+            return Result::Error;
+        }
+
+        const Trajectory<DOFs, CustomVector>& trajectory = trajectories[front];
+        if (output.new_calculation) {
+            output.time = static_cast<double>(current_cycle - front_start_cycle) * otg.delta_time;
+        } else {
+            output.time += otg.delta_time;
+        }
+
+        const size_t old_section = output.new_section;
+        trajectory.at_time(output.time, output.new_position, output.new_velocity, output.new_acceleration, output.new_jerk, output.new_section);
+        output.did_section_change = (output.new_section > old_section);
+
+        if (output.time > trajectory.get_duration()) {
+            return Result::Finished;
+        }
+        return Result::Working;
+    }
+
+    //! Get the trajectory that is currently sampled (real-time thread only)
+    const Trajectory<DOFs, CustomVector>& get_trajectory() const {
+        return trajectories[front];
+    }
+};
+
+} // namespace ruckig
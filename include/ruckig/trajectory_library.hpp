@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ruckig/calculator_target.hpp>
+#include <ruckig/error.hpp>
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/trajectory.hpp>
+
+
+namespace ruckig {
+
+//! @brief Library of precomputed trajectories with a k-d tree index over their start and target states
+//!
+//! A query returns the stored trajectory with the closest current and target state, and re-times it to the queried
+//! input with a single Step 2 calculation per DoF at the stored duration, respecting the minimum duration and the
+//! duration discretization of the input. If that duration is not feasible for the query, the library falls back to a
+//! full calculation.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class TrajectoryLibrary {
+    struct Node {
+        size_t entry;
+        size_t axis;
+        size_t left, right; // Index of the child nodes, or no_node
+    };
+
+    constexpr static size_t no_node {std::numeric_limits<size_t>::max()};
+
+    //! Flattened keys of all entries, each of size number_of_features
+    std::vector<double> keys;
+    std::vector<Trajectory<DOFs, CustomVector>> trajectories;
+
+    std::vector<Node> nodes;
+    size_t root {no_node};
+
+    TargetCalculator<DOFs, CustomVector> calculator;
+
+    //! Key of the current query, so that a query does not allocate memory
+    mutable StandardSizeVector<double, DOFs, 6*DOFs> query_key;
+
+    size_t number_of_features() const {
+        return 6 * degrees_of_freedom;
+    }
+
+    template<class Output>
+    void input_to_key(const InputParameter<DOFs, CustomVector>& input, Output key) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            key[dof] = position_weight * input.current_position[dof];
+            key[degrees_of_freedom + dof] = velocity_weight * input.current_velocity[dof];
+            key[2 * degrees_of_freedom + dof] = acceleration_weight * input.current_acceleration[dof];
+            key[3 * degrees_of_freedom + dof] = position_weight * input.target_position[dof];
+            key[4 * degrees_of_freedom + dof] = velocity_weight * input.target_velocity[dof];
+            key[5 * degrees_of_freedom + dof] = acceleration_weight * input.target_acceleration[dof];
+        }
+    }
+
+    const double* get_key(size_t entry) const {
+        return keys.data() + entry * number_of_features();
+    }
+
+    double squared_distance(const double* a, const double* b) const {
+        double result {0.0};
+        for (size_t i = 0; i < number_of_features(); ++i) {
+            result += (a[i] - b[i]) * (a[i] - b[i]);
+        }
+        return result;
+    }
+
+    size_t build_node(std::vector<size_t>::iterator begin, std::vector<size_t>::iterator end, size_t depth) {
+        if (begin == end) {
+            return no_node;
+        }
+
+        const size_t axis = depth % number_of_features();
+        const auto median = begin + std::distance(begin, end) / 2;
+        std::nth_element(begin, median, end, [&](size_t a, size_t b) { return get_key(a)[axis] < get_key(b)[axis]; });
+
+        const size_t index = nodes.size();
+        nodes.push_back(Node {*median, axis, no_node, no_node});
+        const size_t left = build_node(begin, median, depth + 1);
+        const size_t right = build_node(median + 1, end, depth + 1);
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+    }
+
+    void search_node(size_t index, const double* query, size_t& best_entry, double& best_distance) const {
+        if (index == no_node) {
+            return;
+        }
+
+        const Node& node = nodes[index];
+        const double distance = squared_distance(query, get_key(node.entry));
+        if (distance < best_distance) {
+            best_distance = distance;
+            best_entry = node.entry;
+        }
+
+        const double axis_distance = query[node.axis] - get_key(node.entry)[node.axis];
+        const size_t near = (axis_distance < 0.0) ? node.left : node.right;
+        const size_t far = (axis_distance < 0.0) ? node.right : node.left;
+
+        search_node(near, query, best_entry, best_distance);
+        if (axis_distance * axis_distance < best_distance) {
+            search_node(far, query, best_entry, best_distance);
+        }
+    }
+
+public:
+    size_t degrees_of_freedom;
+
+    //! Time step between updates (cycle time) in [s], required for discrete durations
+    double delta_time {-1.0};
+
+    //! Weights of the kinematic state for the distance metric
+    double position_weight {1.0}, velocity_weight {1.0}, acceleration_weight {1.0};
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TrajectoryLibrary(): degrees_of_freedom(DOFs) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TrajectoryLibrary(double delta_time): degrees_of_freedom(DOFs), delta_time(delta_time) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TrajectoryLibrary(size_t dofs): calculator(TargetCalculator<DOFs, CustomVector>(dofs)), query_key(6 * dofs), degrees_of_freedom(dofs) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TrajectoryLibrary(size_t dofs, double delta_time): calculator(TargetCalculator<DOFs, CustomVector>(dofs)), query_key(6 * dofs), degrees_of_freedom(dofs), delta_time(delta_time) { }
+
+    //! Add a precomputed trajectory for the given input. The index needs to be rebuilt afterwards.
+    void add(const InputParameter<DOFs, CustomVector>& input, const Trajectory<DOFs, CustomVector>& trajectory) {
+        keys.resize(keys.size() + number_of_features());
+        input_to_key(input, keys.end() - number_of_features());
+        trajectories.push_back(trajectory);
+        root = no_node;
+    }
+
+    //! Build the k-d tree index over all added trajectories
+    void build() {
+        std::vector<size_t> entries(trajectories.size());
+        std::iota(entries.begin(), entries.end(), 0);
+
+        nodes.clear();
+        nodes.reserve(entries.size());
+        root = build_node(entries.begin(), entries.end(), 0);
+    }
+
+    //! Number of stored trajectories
+    size_t size() const {
+        return trajectories.size();
+    }
+
+    //! Get a stored trajectory
+    const Trajectory<DOFs, CustomVector>& get_trajectory(size_t entry) const {
+        return trajectories[entry];
+    }
+
+    //! Find the index of the stored trajectory with the closest current and target state. This does not allocate
+    //! memory, but uses a buffer of the library so that it must not be called concurrently.
+    std::optional<size_t> find_nearest(const InputParameter<DOFs, CustomVector>& input) const {
+        if (root == no_node) {
+            return std::nullopt;
+        }
+
+        input_to_key(input, query_key.begin());
+
+        size_t best_entry {no_node};
+        double best_distance {std::numeric_limits<double>::infinity()};
+        search_node(root, query_key.data(), best_entry, best_distance);
+        return best_entry;
+    }
+
+    //! @brief Calculate a trajectory for the input by re-timing the closest stored trajectory
+    //!
+    //! The stored duration is extended to the minimum duration of the input, and rounded up to the control cycle for
+    //! discrete durations. Falls back to a full calculation if the library is empty or that duration is not feasible
+    //! for the given input. An interrupted full calculation is continued until it is completed. The input is not
+    //! validated.
+    template<bool throw_error = false>
+    Result calculate(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory, bool& found_in_library) {
+        found_in_library = false;
+
+        const bool discrete_duration = (input.duration_discretization == DurationDiscretization::Discrete);
+        if (discrete_duration && delta_time <= 0.0) {
+            if constexpr (throw_error) {
+                throw RuckigError("delta time (control rate) parameter " + std::to_string(delta_time) + " should be larger than zero.");
+            } else {
+                return Result::ErrorInvalidInput;
+            }
+        }
+
+        const auto entry = find_nearest(input);
+        if (entry) {
+            double duration = std::max(trajectories[*entry].get_duration(), input.minimum_duration.value_or(0.0));
+            if (discrete_duration) {
+                duration = round_up_to_cycle(duration, delta_time);
+            }
+
+            if (calculator.template calculate_with_duration<false>(input, trajectory, duration) == Result::Working) {
+                found_in_library = true;
+                return Result::Working;
+            }
+        }
+
+        bool was_interrupted {false};
+        Result result = calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
+        while (result == Result::Working && was_interrupted) {
+            result = calculator.template continue_calculation<throw_error>(input, trajectory, delta_time, was_interrupted);
+        }
+        return result;
+    }
+};
+
+} // namespace ruckig
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <ruckig/error.hpp>
+#include <ruckig/profile.hpp>
+#include <ruckig/trajectory.hpp>
+
+
+namespace ruckig {
+
+//! Header of the binary trajectory format
+struct BinaryTrajectoryHeader {
+    constexpr static char magic_value[8] {'R', 'U', 'C', 'K', 'I', 'G', 'T', 'R'};
+    constexpr static uint32_t current_version {1};
+    constexpr static uint32_t byte_order_value {0x01020304};
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; ///< Written in native byte order, to detect files from machines with a different endianness
+    uint32_t header_size;
+    uint32_t profile_size; ///< sizeof(Profile) of the writing machine
+    uint64_t degrees_of_freedom;
+    uint64_t number_of_sections;
+    double duration;
+    uint64_t payload_size;
+    uint64_t payload_checksum; ///< FNV-1a hash of the payload
+    uint64_t header_checksum; ///< FNV-1a hash of all header bytes before this field
+
+    //! Offsets of the payload arrays, relative to the start of the header
+    uint64_t profiles_offset() const {
+        return header_size;
+    }
+
+    uint64_t cumulative_times_offset() const {
+        return profiles_offset() + number_of_sections * degrees_of_freedom * sizeof(Profile);
+    }
+
+    uint64_t independent_min_durations_offset() const {
+        return cumulative_times_offset() + number_of_sections * sizeof(double);
+    }
+
+    static uint64_t get_payload_size(uint64_t degrees_of_freedom, uint64_t number_of_sections) {
+        return number_of_sections * degrees_of_freedom * sizeof(Profile) + number_of_sections * sizeof(double) + degrees_of_freedom * sizeof(double);
+    }
+
+    static uint64_t checksum(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+};
+
+static_assert(std::is_trivially_copyable<Profile>::value, "Profile needs to be trivially copyable for the binary trajectory format.");
+static_assert(sizeof(BinaryTrajectoryHeader) % alignof(Profile) == 0, "Payload after the binary header needs to be aligned.");
+
+
+//! @brief Read-only view of a trajectory stored in the binary format, e.g. within a memory-mapped file
+//!
+//! The view only references the given memory, so the buffer needs to outlive the view. The buffer needs to be
+//! aligned to at least 8 bytes, which holds for memory-mapped files and for buffers allocated with new or malloc.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class TrajectoryView {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+
+    const Profile* profiles {nullptr};
+    const double* cumulative_times {nullptr};
+    const double* independent_min_durations {nullptr};
+
+    size_t number_of_sections {0};
+    double duration {0.0};
+
+    template<typename Func>
+    void state_to_integrate_from(double time, size_t& new_section, Func&& set_integrate) const {
+        Trajectory<DOFs, CustomVector>::state_to_integrate_from(time, duration, cumulative_times, number_of_sections, degrees_of_freedom, [this](size_t section, size_t dof) -> decltype(auto) {
+            return profiles[section * degrees_of_freedom + dof];
+        }, new_section, std::forward<Func>(set_integrate));
+    }
+
+    template<bool throw_validation_error>
+    static bool fail(const std::string& message) {
+        if constexpr (throw_validation_error) {
+            throw RuckigError("invalid binary trajectory: " + message);
+        }
+        return false;
+    }
+
+public:
+    size_t degrees_of_freedom {DOFs};
+
+    //! Get the number of bytes needed to store the trajectory in the binary format
+    static size_t get_binary_size(const Trajectory<DOFs, CustomVector>& trajectory) {
+        return sizeof(BinaryTrajectoryHeader) + BinaryTrajectoryHeader::get_payload_size(trajectory.degrees_of_freedom, trajectory.profiles.size());
+    }
+
+    //! Write the trajectory in the binary format into the given (8-byte aligned) buffer, returns the number of written bytes
+    static size_t write(const Trajectory<DOFs, CustomVector>& trajectory, void* buffer, size_t size) {
+        const size_t binary_size = get_binary_size(trajectory);
+        if (size < binary_size) {
+            throw RuckigError("buffer of size " + std::to_string(size) + " is too small for binary trajectory of size " + std::to_string(binary_size) + ".");
+        }
+
+        const size_t dofs = trajectory.degrees_of_freedom;
+        const size_t sections = trajectory.profiles.size();
+
+        BinaryTrajectoryHeader header;
+        std::memcpy(header.magic, BinaryTrajectoryHeader::magic_value, sizeof(header.magic));
+        header.version = BinaryTrajectoryHeader::current_version;
+        header.byte_order = BinaryTrajectoryHeader::byte_order_value;
+        header.header_size = sizeof(BinaryTrajectoryHeader);
+        header.profile_size = sizeof(Profile);
+        header.degrees_of_freedom = dofs;
+        header.number_of_sections = sections;
+        header.duration = trajectory.duration;
+        header.payload_size = BinaryTrajectoryHeader::get_payload_size(dofs, sections);
+
+        auto* bytes = static_cast<unsigned char*>(buffer);
+        auto* profiles_ptr = bytes + header.profiles_offset();
+        for (size_t i = 0; i < sections; ++i) {
+            for (size_t dof = 0; dof < dofs; ++dof) {
+                std::memcpy(profiles_ptr + (i * dofs + dof) * sizeof(Profile), &trajectory.profiles[i][dof], sizeof(Profile));
+            }
+        }
+        std::memcpy(bytes + header.cumulative_times_offset(), trajectory.cumulative_times.data(), sections * sizeof(double));
+        for (size_t dof = 0; dof < dofs; ++dof) {
+            const double t_min = trajectory.independent_min_durations[dof];
+            std::memcpy(bytes + header.independent_min_durations_offset() + dof * sizeof(double), &t_min, sizeof(double));
+        }
+
+        header.payload_checksum = BinaryTrajectoryHeader::checksum(profiles_ptr, header.payload_size);
+        header.header_checksum = BinaryTrajectoryHeader::checksum(&header, offsetof(BinaryTrajectoryHeader, header_checksum));
+        std::memcpy(bytes, &header, sizeof(BinaryTrajectoryHeader));
+        return binary_size;
+    }
+
+    //! Serialize the trajectory into a newly allocated buffer
+    static std::vector<uint64_t> write(const Trajectory<DOFs, CustomVector>& trajectory) {
+        const size_t binary_size = get_binary_size(trajectory);
+        std::vector<uint64_t> buffer((binary_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        write(trajectory, buffer.data(), buffer.size() * sizeof(uint64_t));
+        return buffer;
+    }
+
+    TrajectoryView() { }
+
+    //! Load and validate the binary trajectory, throws a RuckigError for invalid data
+    explicit TrajectoryView(const void* data, size_t size, bool verify_checksum = true) {
+        load<true>(data, size, verify_checksum);
+    }
+
+    //! Validate the binary trajectory and reference its data without copying. The payload checksum is
+    //! an O(n) pass over the data and can be skipped for trusted files.
+    template<bool throw_validation_error = true>
+    bool load(const void* data, size_t size, bool verify_checksum = true) {
+        profiles = nullptr;
+        cumulative_times = nullptr;
+        independent_min_durations = nullptr;
+        number_of_sections = 0;
+        duration = 0.0;
+
+        if (data == nullptr || size < sizeof(BinaryTrajectoryHeader)) {
+            return fail<throw_validation_error>("buffer is smaller than the header.");
+        }
+        if (reinterpret_cast<uintptr_t>(data) % alignof(Profile) != 0) {
+            return fail<throw_validation_error>("buffer is not aligned to " + std::to_string(alignof(Profile)) + " bytes.");
+        }
+
+        BinaryTrajectoryHeader header;
+        std::memcpy(&header, data, sizeof(BinaryTrajectoryHeader));
+
+        if (std::memcmp(header.magic, BinaryTrajectoryHeader::magic_value, sizeof(header.magic)) != 0) {
+            return fail<throw_validation_error>("magic bytes do not match.");
+        }
+        if (header.byte_order != BinaryTrajectoryHeader::byte_order_value) {
+            return fail<throw_validation_error>("byte order does not match this machine.");
+        }
+        if (header.header_checksum != BinaryTrajectoryHeader::checksum(&header, offsetof(BinaryTrajectoryHeader, header_checksum))) {
+            return fail<throw_validation_error>("header checksum does not match.");
+        }
+        if (header.version != BinaryTrajectoryHeader::current_version) {
+            return fail<throw_validation_error>("version " + std::to_string(header.version) + " is not supported.");
+        }
+        if (header.header_size != sizeof(BinaryTrajectoryHeader) || header.profile_size != sizeof(Profile)) {
+            return fail<throw_validation_error>("memory layout does not match this build.");
+        }
+        if constexpr (DOFs >= 1) {
+            if (header.degrees_of_freedom != DOFs) {
+                return fail<throw_validation_error>("mismatch in degrees of freedom " + std::to_string(header.degrees_of_freedom) + ".");
+            }
+        }
+        if (header.degrees_of_freedom == 0 || header.number_of_sections == 0) {
+            return fail<throw_validation_error>("trajectory is empty.");
+        }
+
+        // Check for overflow of the counts and their product before comparing the sizes
+        const uint64_t max_payload_size = size - sizeof(BinaryTrajectoryHeader);
+        const uint64_t max_count = max_payload_size / sizeof(double);
+        if (header.degrees_of_freedom > max_count || header.number_of_sections > max_count || header.number_of_sections > max_payload_size / sizeof(Profile) / header.degrees_of_freedom || header.payload_size != BinaryTrajectoryHeader::get_payload_size(header.degrees_of_freedom, header.number_of_sections) || header.payload_size > size - sizeof(BinaryTrajectoryHeader)) {
+            return fail<throw_validation_error>("payload size does not match the buffer size.");
+        }
+
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        if (verify_checksum && header.payload_checksum != BinaryTrajectoryHeader::checksum(bytes + header.profiles_offset(), header.payload_size)) {
+            return fail<throw_validation_error>("payload checksum does not match.");
+        }
+
+        degrees_of_freedom = header.degrees_of_freedom;
+        number_of_sections = header.number_of_sections;
+        duration = header.duration;
+        profiles = reinterpret_cast<const Profile*>(bytes + header.profiles_offset());
+        cumulative_times = reinterpret_cast<const double*>(bytes + header.cumulative_times_offset());
+        independent_min_durations = reinterpret_cast<const double*>(bytes + header.independent_min_durations_offset());
+        return true;
+    }
+
+    //! Was a trajectory loaded successfully?
+    bool is_valid() const {
+        return profiles != nullptr;
+    }
+
+    //! Get the kinematic state, the jerk, and the section at a given time
+    void at_time(double time, Vector<double>& new_position, Vector<double>& new_velocity, Vector<double>& new_acceleration, Vector<double>& new_jerk, size_t& new_section) const {
+        if constexpr (DOFs == 0) {
+            if (degrees_of_freedom != new_position.size() || degrees_of_freedom != new_velocity.size() || degrees_of_freedom != new_acceleration.size() || degrees_of_freedom != new_jerk.size()) {
+                throw RuckigError("mismatch in degrees of freedom (vector size).");
+            }
+        }
+
+        state_to_integrate_from(time, new_section, [&](size_t dof, double t, double p, double v, double a, double j) {
+            std::tie(new_position[dof], new_velocity[dof], new_acceleration[dof]) = integrate(t, p, v, a, j);
+            new_jerk[dof] = j;
+        });
+    }
+
+    //! Get the kinematic state at a given time
+    void at_time(double time, Vector<double>& new_position, Vector<double>& new_velocity, Vector<double>& new_acceleration) const {
+        if constexpr (DOFs == 0) {
+            if (degrees_of_freedom != new_position.size() || degrees_of_freedom != new_velocity.size() || degrees_of_freedom != new_acceleration.size()) {
+                throw RuckigError("mismatch in degrees of freedom (vector size).");
+            }
+        }
+
+        size_t new_section;
+        state_to_integrate_from(time, new_section, [&](size_t dof, double t, double p, double v, double a, double j) {
+            std::tie(new_position[dof], new_velocity[dof], new_acceleration[dof]) = integrate(t, p, v, a, j);
+        });
+    }
+
+    //! Get the position at a given time
+    void at_time(double time, Vector<double>& new_position) const {
+        if constexpr (DOFs == 0) {
+            if (degrees_of_freedom != new_position.size()) {
+                throw RuckigError("mismatch in degrees of freedom (vector size).");
+            }
+        }
+
+        size_t new_section;
+        state_to_integrate_from(time, new_section, [&](size_t dof, double t, double p, double v, double a, double j) {
+            std::tie(new_position[dof], std::ignore, std::ignore) = integrate(t, p, v, a, j);
+        });
+    }
+
+    //! Get the profile of a given section and DoF
+    const Profile& get_profile(size_t section, size_t dof) const {
+        return profiles[section * degrees_of_freedom + dof];
+    }
+
+    //! Get the number of sections between intermediate waypoints
+    size_t get_number_of_sections() const {
+        return number_of_sections;
+    }
+
+    //! Get the duration of the (synchronized) trajectory
+    double get_duration() const {
+        return duration;
+    }
+
+    //! Get the duration when the intermediate waypoint of the given section is reached
+    double get_intermediate_duration(size_t section) const {
+        return cumulative_times[section];
+    }
+
+    //! Get the minimum duration of the given independent DoF
+    double get_independent_min_duration(size_t dof) const {
+        return independent_min_durations[dof];
+    }
+};
+
+} // namespace ruckig
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -49,4 +50,14 @@ inline std::tuple<double, double, double> integrate(double t, double p0, double
     );
 }
 
+
+//! Round a duration up to an integer number of control cycles, the division might round over an integer
+inline double round_up_to_cycle(double t, double delta_time) {
+    double cycles = std::ceil(t / delta_time);
+    if ((cycles - 1.0) * delta_time >= t) {
+        cycles -= 1.0;
+    }
+    return cycles * delta_time;
+}
+
 } // namespace ruckig
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/utils.hpp>
+
+
+namespace ruckig {
+
+//! @brief Bounded queue of waypoints for streaming them into the input while executing a path
+//!
+//! Waypoints are appended to a ring buffer of fixed capacity, so that the memory is bounded independent of the length
+//! of the path. Only a window of the first waypoints (the look-ahead) is passed to the input: All but the last waypoint
+//! of the window become intermediate positions, and the last one becomes the target position. The waypoint of a
+//! completed section is consumed in constant time. The queue never allocates memory after construction, and the first
+//! write reserves the full look-ahead in the intermediate positions of the input. For a fixed number of DoFs, passing the
+//! window to the input afterwards never allocates; with dynamic DoFs, growing the window allocates the new waypoints.
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class WaypointQueue {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+
+    std::vector<Vector<double>> buffer;
+    size_t head {0}; ///< Index of the first waypoint in the buffer
+    size_t count {0};
+
+public:
+    size_t degrees_of_freedom;
+
+    //! Maximum number of intermediate positions that are passed to the input
+    size_t look_ahead;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit WaypointQueue(size_t capacity, size_t look_ahead):
+        buffer(std::max<size_t>(capacity, 1)), degrees_of_freedom(DOFs), look_ahead(look_ahead) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit WaypointQueue(size_t dofs, size_t capacity, size_t look_ahead):
+        buffer(std::max<size_t>(capacity, 1), Vector<double>(dofs)), degrees_of_freedom(dofs), look_ahead(look_ahead) { }
+
+    size_t capacity() const {
+        return buffer.size();
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    bool full() const {
+        return count == buffer.size();
+    }
+
+    //! Get the waypoint at the given index, counted from the front of the queue
+    const Vector<double>& operator[](size_t index) const {
+        return buffer[(head + index) % buffer.size()];
+    }
+
+    const Vector<double>& front() const {
+        return buffer[head];
+    }
+
+    //! Append a waypoint to the queue. Returns false if the queue is full.
+    bool push(const Vector<double>& position) {
+        if (full()) {
+            return false;
+        }
+
+        auto& element = buffer[(head + count) % buffer.size()];
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            element[dof] = position[dof];
+        }
+        ++count;
+        return true;
+    }
+
+    //! Remove the first waypoint. Returns false if the queue is empty.
+    bool pop() {
+        if (empty()) {
+            return false;
+        }
+
+        head = (head + 1) % buffer.size();
+        --count;
+        return true;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    //! Set the intermediate positions and the target position of the input to the current window of waypoints. An empty queue keeps the target position unchanged.
+    void write_to_input(InputParameter<DOFs, CustomVector>& input) const {
+        if (input.intermediate_positions.capacity() < look_ahead) {
+            input.intermediate_positions.reserve(look_ahead);
+        }
+
+        if (empty()) {
+            input.intermediate_positions.clear();
+            return;
+        }
+
+        const size_t window = std::min(count, look_ahead + 1);
+        input.intermediate_positions.resize(window - 1, operator[](0));
+        for (size_t i = 0; i + 1 < window; ++i) {
+            input.intermediate_positions[i] = operator[](i);
+        }
+        input.target_position = operator[](window - 1);
+    }
+};
+
+} // namespace ruckig
@@ -1,7 +1,14 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <limits>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <pybind11/operators.h>
 
@@ -12,6 +19,414 @@ namespace py = pybind11;
 using namespace pybind11::literals; // to bring in the `_a` literal
 using namespace ruckig;
 
+using InputArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+
+//! Copy a NumPy array (or any sequence of numbers) into the existing storage of a vector
+template<class Vector>
+void assign_array(Vector& vector, const InputArray& array) {
+    if (array.ndim() != 1 || static_cast<size_t>(array.shape(0)) != vector.size()) {
+        throw py::value_error("expected an array of size " + std::to_string(vector.size()) + ".");
+    }
+    std::copy_n(array.data(), vector.size(), vector.begin());
+}
+
+//! Expose a vector member as a writeable NumPy array that shares memory with the owning object
+template<class Class, class Vector>
+void def_array_readwrite(py::class_<Class>& cls, const char* name, Vector Class::* member) {
+    cls.def_property(name, [member](py::object self) {
+        Vector& vector = self.cast<Class&>().*member;
+        return py::array_t<double>(static_cast<py::ssize_t>(vector.size()), vector.data(), self);
+    }, [member](Class& self, const InputArray& array) {
+        assign_array(self.*member, array);
+    });
+}
+
+//! Expose a vector member as a NumPy array copy, e.g. for output states that are overwritten in every cycle
+template<class Class, class Vector>
+void def_array_readonly(py::class_<Class>& cls, const char* name, Vector Class::* member) {
+    cls.def_property_readonly(name, [member](const Class& self) {
+        const Vector& vector = self.*member;
+        return py::array_t<double>(static_cast<py::ssize_t>(vector.size()), vector.data());
+    });
+}
+
+//! Evaluate the trajectory at multiple times with the GIL released
+template<size_t DOFs>
+py::tuple trajectory_at_times(const Trajectory<DOFs>& traj, const InputArray& times, bool return_section) {
+    if (times.ndim() != 1) {
+        throw py::value_error("expected a one-dimensional array of times.");
+    }
+
+    const size_t n = times.shape(0);
+    const size_t dofs = traj.degrees_of_freedom;
+    py::array_t<double> positions({n, dofs}), velocities({n, dofs}), accelerations({n, dofs});
+    py::array_t<size_t> sections(n);
+
+    const double* time_data = times.data();
+    double* position_data = positions.mutable_data();
+    double* velocity_data = velocities.mutable_data();
+    double* acceleration_data = accelerations.mutable_data();
+    size_t* section_data = sections.mutable_data();
+    {
+        py::gil_scoped_release release;
+
+        StandardVector<double, DOFs> new_position, new_velocity, new_acceleration, new_jerk;
+        if constexpr (DOFs == 0) {
+            new_position.resize(dofs);
+            new_velocity.resize(dofs);
+            new_acceleration.resize(dofs);
+            new_jerk.resize(dofs);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            traj.at_time(time_data[i], new_position, new_velocity, new_acceleration, new_jerk, section_data[i]);
+            std::copy_n(new_position.begin(), dofs, position_data + i * dofs);
+            std::copy_n(new_velocity.begin(), dofs, velocity_data + i * dofs);
+            std::copy_n(new_acceleration.begin(), dofs, acceleration_data + i * dofs);
+        }
+    }
+
+    if (return_section) {
+        return py::make_tuple(positions, velocities, accelerations, sections);
+    }
+    return py::make_tuple(positions, velocities, accelerations);
+}
+
+//! Row-wise access to a (n, dofs) array, or to a (dofs,) array that is broadcasted to all rows
+class ArrayRows {
+    const double* data {nullptr};
+    size_t stride {0};
+
+public:
+    explicit ArrayRows(const std::optional<InputArray>& array, size_t n, size_t dofs, const std::string& name) {
+        if (!array) {
+            return;
+        }
+
+        if (array->ndim() == 2 && static_cast<size_t>(array->shape(0)) == n && static_cast<size_t>(array->shape(1)) == dofs) {
+            stride = dofs;
+        } else if (array->ndim() != 1 || static_cast<size_t>(array->shape(0)) != dofs) {
+            throw py::value_error(name + " needs to be of shape (" + std::to_string(n) + ", " + std::to_string(dofs) + ") or (" + std::to_string(dofs) + ",).");
+        }
+        data = array->data();
+    }
+
+    //! Copy a row into the vector, or keep the vector unchanged if no array was given
+    void copy_row(size_t i, std::vector<double>& vector) const {
+        if (data) {
+            std::copy_n(data + i * stride, vector.size(), vector.begin());
+        }
+    }
+};
+
+//! @brief Calculate many independent trajectories from columnar arrays in parallel, with the GIL released
+//!
+//! Returns the results and durations of all trajectories, and optionally the kinematic state at number_of_samples
+//! equidistant times of each trajectory as (n, number_of_samples, dofs) arrays.
+py::tuple calculate_many(const InputArray& current_position, const InputArray& target_position, const InputArray& max_velocity, const InputArray& max_acceleration, const InputArray& max_jerk, const std::optional<InputArray>& current_velocity, const std::optional<InputArray>& current_acceleration, const std::optional<InputArray>& target_velocity, const std::optional<InputArray>& target_acceleration, size_t number_of_samples, size_t number_of_threads) {
+    if (current_position.ndim() != 2) {
+        throw py::value_error("current_position needs to be of shape (n, dofs).");
+    }
+
+    const size_t n = current_position.shape(0);
+    const size_t dofs = current_position.shape(1);
+    const std::array<ArrayRows, 9> rows {
+        ArrayRows(current_position, n, dofs, "current_position"),
+        ArrayRows(current_velocity, n, dofs, "current_velocity"),
+        ArrayRows(current_acceleration, n, dofs, "current_acceleration"),
+        ArrayRows(target_position, n, dofs, "target_position"),
+        ArrayRows(target_velocity, n, dofs, "target_velocity"),
+        ArrayRows(target_acceleration, n, dofs, "target_acceleration"),
+        ArrayRows(max_velocity, n, dofs, "max_velocity"),
+        ArrayRows(max_acceleration, n, dofs, "max_acceleration"),
+        ArrayRows(max_jerk, n, dofs, "max_jerk"),
+    };
+
+    py::array_t<int> results(n);
+    py::array_t<double> durations(n);
+    py::array_t<double> positions({n, number_of_samples, dofs}), velocities({n, number_of_samples, dofs}), accelerations({n, number_of_samples, dofs});
+
+    int* result_data = results.mutable_data();
+    double* duration_data = durations.mutable_data();
+    double* position_data = positions.mutable_data();
+    double* velocity_data = velocities.mutable_data();
+    double* acceleration_data = accelerations.mutable_data();
+    {
+        py::gil_scoped_release release;
+
+        std::atomic<size_t> next_row {0};
+        const auto worker = [&]() {
+            Ruckig<DynamicDOFs> otg {dofs};
+            InputParameter<DynamicDOFs> input {dofs};
+            Trajectory<DynamicDOFs> trajectory {dofs};
+            std::vector<double> new_position(dofs), new_velocity(dofs), new_acceleration(dofs);
+
+            for (size_t i = next_row++; i < n; i = next_row++) {
+                rows[0].copy_row(i, input.current_position);
+                rows[1].copy_row(i, input.current_velocity);
+                rows[2].copy_row(i, input.current_acceleration);
+                rows[3].copy_row(i, input.target_position);
+                rows[4].copy_row(i, input.target_velocity);
+                rows[5].copy_row(i, input.target_acceleration);
+                rows[6].copy_row(i, input.max_velocity);
+                rows[7].copy_row(i, input.max_acceleration);
+                rows[8].copy_row(i, input.max_jerk);
+
+                const Result result = otg.calculate(input, trajectory);
+                const bool is_valid = (result == Result::Working || result == Result::ErrorPositionalLimits);
+                result_data[i] = static_cast<int>(result);
+                duration_data[i] = is_valid ? trajectory.get_duration() : std::numeric_limits<double>::quiet_NaN();
+
+                for (size_t sample = 0; sample < number_of_samples; ++sample) {
+                    const size_t offset = (i * number_of_samples + sample) * dofs;
+                    if (!is_valid) {
+                        std::fill_n(position_data + offset, dofs, std::numeric_limits<double>::quiet_NaN());
+                        std::fill_n(velocity_data + offset, dofs, std::numeric_limits<double>::quiet_NaN());
+                        std::fill_n(acceleration_data + offset, dofs, std::numeric_limits<double>::quiet_NaN());
+                        continue;
+                    }
+
+                    const double time = (number_of_samples > 1) ? trajectory.get_duration() * sample / (number_of_samples - 1) : 0.0;
+                    trajectory.at_time(time, new_position, new_velocity, new_acceleration);
+                    std::copy_n(new_position.begin(), dofs, position_data + offset);
+                    std::copy_n(new_velocity.begin(), dofs, velocity_data + offset);
+                    std::copy_n(new_acceleration.begin(), dofs, acceleration_data + offset);
+                }
+            }
+        };
+
+        if (number_of_threads == 0) {
+            number_of_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        number_of_threads = std::max<size_t>(std::min(number_of_threads, n), 1);
+
+        std::vector<std::thread> threads;
+        threads.reserve(number_of_threads - 1);
+        for (size_t i = 1; i < number_of_threads; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    if (number_of_samples > 0) {
+        return py::make_tuple(results, durations, positions, velocities, accelerations);
+    }
+    return py::make_tuple(results, durations);
+}
+
+
+//! Bind the trajectory, input, output, and Ruckig classes for the given number of DoFs, with a suffix to the class names
+template<size_t DOFs>
+void bind_dofs(py::module_& m, const std::string& suffix) {
+    using Traj = Trajectory<DOFs>;
+    using Input = InputParameter<DOFs>;
+    using Output = OutputParameter<DOFs>;
+    using Otg = RuckigThrow<DOFs>;
+    using Queue = WaypointQueue<DOFs>;
+
+    py::class_<Traj> trajectory(m, ("Trajectory" + suffix).c_str());
+    if constexpr (DOFs == 0) {
+        trajectory.def(py::init<size_t>(), "dofs"_a);
+#if defined WITH_CLOUD_CLIENT
+        trajectory.def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a);
+#endif
+    } else {
+        trajectory.def(py::init<>());
+#if defined WITH_CLOUD_CLIENT
+        trajectory.def(py::init<size_t>(), "max_number_of_waypoints"_a);
+#endif
+    }
+    trajectory
+        .def_readonly("degrees_of_freedom", &Traj::degrees_of_freedom)
+        .def_property_readonly("profiles", &Traj::get_profiles)
+        .def_property_readonly("duration", &Traj::get_duration)
+        .def_property_readonly("intermediate_durations", &Traj::get_intermediate_durations)
+        .def_property_readonly("independent_min_durations", &Traj::get_independent_min_durations)
+        .def_property_readonly("position_extrema", &Traj::get_position_extrema)
+        .def_property_readonly("velocity_extrema", &Traj::get_velocity_extrema)
+        .def_property_readonly("acceleration_extrema", &Traj::get_acceleration_extrema)
+        .def_property_readonly("jerk_extrema", &Traj::get_jerk_extrema)
+        .def("get_section_extrema", &Traj::get_section_extrema, "section"_a)
+        .def("get_time_intervals_within_position", &Traj::get_time_intervals_within_position, "dof"_a, "min_position"_a, "max_position"_a)
+        .def("get_time_intervals_within_box", &Traj::get_time_intervals_within_box, "min_position"_a, "max_position"_a)
+        .def("get_position_bounds", &Traj::get_position_bounds, "t_start"_a, "t_end"_a)
+        .def("get_swept_position_bounds", py::overload_cast<>(&Traj::get_swept_position_bounds, py::const_))
+        .def("get_swept_position_bounds", py::overload_cast<const std::vector<double>&>(&Traj::get_swept_position_bounds, py::const_), "time_partition"_a)
+        .def("at_time", [](const Traj& traj, double time, bool return_section=false) {
+            StandardVector<double, DOFs> new_position, new_velocity, new_acceleration, new_jerk;
+            if constexpr (DOFs == 0) {
+                new_position.resize(traj.degrees_of_freedom);
+                new_velocity.resize(traj.degrees_of_freedom);
+                new_acceleration.resize(traj.degrees_of_freedom);
+                new_jerk.resize(traj.degrees_of_freedom);
+            }
+            size_t new_section;
+            traj.at_time(time, new_position, new_velocity, new_acceleration, new_jerk, new_section);
+            const auto position_array = py::array_t<double>(new_position.size(), new_position.data());
+            const auto velocity_array = py::array_t<double>(new_velocity.size(), new_velocity.data());
+            const auto acceleration_array = py::array_t<double>(new_acceleration.size(), new_acceleration.data());
+            if (return_section) {
+                return py::make_tuple(position_array, velocity_array, acceleration_array, new_section);
+            }
+            return py::make_tuple(position_array, velocity_array, acceleration_array);
+        }, "time"_a, "return_section"_a=false)
+        .def("at_times", &trajectory_at_times<DOFs>, "times"_a, "return_section"_a=false)
+        .def("get_first_time_at_position", [](const Traj& traj, size_t dof, double position) -> py::object {
+            double time;
+            if (traj.get_first_time_at_position(dof, position, time)) {
+                return py::cast(time);
+            }
+            return py::none();
+        }, "dof"_a, "position"_a);
+
+    py::class_<Input> input_parameter(m, ("InputParameter" + suffix).c_str());
+    if constexpr (DOFs == 0) {
+        input_parameter.def(py::init<size_t>(), "dofs"_a);
+#if defined WITH_CLOUD_CLIENT
+        input_parameter.def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a);
+#endif
+    } else {
+        input_parameter.def(py::init<>());
+#if defined WITH_CLOUD_CLIENT
+        input_parameter.def(py::init<size_t>(), "max_number_of_waypoints"_a);
+#endif
+    }
+    input_parameter
+        .def_readonly("degrees_of_freedom", &Input::degrees_of_freedom)
+        .def_readwrite("min_velocity", &Input::min_velocity)
+        .def_readwrite("min_acceleration", &Input::min_acceleration)
+        .def_readwrite("intermediate_positions", &Input::intermediate_positions)
+        .def_readwrite("per_section_max_velocity", &Input::per_section_max_velocity)
+        .def_readwrite("per_section_max_acceleration", &Input::per_section_max_acceleration)
+        .def_readwrite("per_section_max_jerk", &Input::per_section_max_jerk)
+        .def_readwrite("per_section_min_velocity", &Input::per_section_min_velocity)
+        .def_readwrite("per_section_min_acceleration", &Input::per_section_min_acceleration)
+        .def_readwrite("per_section_max_position", &Input::per_section_max_position)
+        .def_readwrite("per_section_min_position", &Input::per_section_min_position)
+        .def_readwrite("max_position", &Input::max_position)
+        .def_readwrite("min_position", &Input::min_position)
+        .def_readwrite("enabled", &Input::enabled)
+        .def_readwrite("control_interface", &Input::control_interface)
+        .def_readwrite("synchronization", &Input::synchronization)
+        .def_readwrite("duration_discretization", &Input::duration_discretization)
+        .def_readwrite("per_dof_control_interface", &Input::per_dof_control_interface)
+        .def_readwrite("per_dof_synchronization", &Input::per_dof_synchronization)
+        .def_readwrite("minimum_duration", &Input::minimum_duration)
+        .def_readwrite("per_section_minimum_duration", &Input::per_section_minimum_duration)
+        .def_readwrite("interrupt_calculation_duration", &Input::interrupt_calculation_duration)
+        .def("validate", &Input::template validate<true>, "check_current_state_within_limits"_a=false, "check_target_state_within_limits"_a=true)
+        .def(py::self != py::self)
+        .def("__repr__", &Input::to_string);
+
+    // The kinematic state is exposed as NumPy arrays sharing memory with the input parameter
+    def_array_readwrite(input_parameter, "current_position", &Input::current_position);
+    def_array_readwrite(input_parameter, "current_velocity", &Input::current_velocity);
+    def_array_readwrite(input_parameter, "current_acceleration", &Input::current_acceleration);
+    def_array_readwrite(input_parameter, "target_position", &Input::target_position);
+    def_array_readwrite(input_parameter, "target_velocity", &Input::target_velocity);
+    def_array_readwrite(input_parameter, "target_acceleration", &Input::target_acceleration);
+    def_array_readwrite(input_parameter, "max_velocity", &Input::max_velocity);
+    def_array_readwrite(input_parameter, "max_acceleration", &Input::max_acceleration);
+    def_array_readwrite(input_parameter, "max_jerk", &Input::max_jerk);
+
+    py::class_<Queue> waypoint_queue(m, ("WaypointQueue" + suffix).c_str());
+    if constexpr (DOFs == 0) {
+        waypoint_queue.def(py::init<size_t, size_t, size_t>(), "dofs"_a, "capacity"_a, "look_ahead"_a);
+    } else {
+        waypoint_queue.def(py::init<size_t, size_t>(), "capacity"_a, "look_ahead"_a);
+    }
+    waypoint_queue
+        .def_readonly("degrees_of_freedom", &Queue::degrees_of_freedom)
+        .def_readwrite("look_ahead", &Queue::look_ahead)
+        .def_property_readonly("capacity", &Queue::capacity)
+        .def("empty", &Queue::empty)
+        .def("full", &Queue::full)
+        .def("front", &Queue::front)
+        .def("push", &Queue::push, "position"_a)
+        .def("pop", &Queue::pop)
+        .def("clear", &Queue::clear)
+        .def("write_to_input", &Queue::write_to_input, "input"_a)
+        .def("__len__", &Queue::size);
+
+    py::class_<Output> output_parameter(m, ("OutputParameter" + suffix).c_str());
+    if constexpr (DOFs == 0) {
+        output_parameter.def(py::init<size_t>(), "dofs"_a);
+#if defined WITH_CLOUD_CLIENT
+        output_parameter.def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a);
+#endif
+    } else {
+        output_parameter.def(py::init<>());
+#if defined WITH_CLOUD_CLIENT
+        output_parameter.def(py::init<size_t>(), "max_number_of_waypoints"_a);
+#endif
+    }
+    output_parameter
+        .def_readonly("degrees_of_freedom", &Output::degrees_of_freedom)
+        .def_readonly("new_section", &Output::new_section)
+        .def_readonly("did_section_change", &Output::did_section_change)
+        .def_readonly("trajectory", &Output::trajectory)
+        .def_readwrite("time", &Output::time)
+        .def_readonly("new_calculation", &Output::new_calculation)
+        .def_readonly("was_calculation_interrupted", &Output::was_calculation_interrupted)
+        .def_readonly("calculation_duration", &Output::calculation_duration)
+        .def_readonly("error", &Output::error)
+        .def("pass_to_input", static_cast<void (Output::*)(Input&) const>(&Output::pass_to_input), "input"_a)
+        .def("pass_to_input", static_cast<void (Output::*)(Input&, Queue&) const>(&Output::pass_to_input), "input"_a, "waypoints"_a)
+        .def("__repr__", &Output::to_string)
+        .def("__copy__",  [](const Output &self) {
+            return Output(self);
+        });
+
+    def_array_readonly(output_parameter, "new_position", &Output::new_position);
+    def_array_readonly(output_parameter, "new_velocity", &Output::new_velocity);
+    def_array_readonly(output_parameter, "new_acceleration", &Output::new_acceleration);
+    def_array_readonly(output_parameter, "new_jerk", &Output::new_jerk);
+
+    py::class_<Otg> ruckig(m, ("Ruckig" + suffix).c_str());
+    if constexpr (DOFs == 0) {
+        ruckig.def(py::init<size_t>(), "dofs"_a);
+        ruckig.def(py::init<size_t, double>(), "dofs"_a, "delta_time"_a);
+#if defined WITH_CLOUD_CLIENT
+        ruckig.def(py::init<size_t, double, size_t>(), "dofs"_a, "delta_time"_a, "max_number_of_waypoints"_a=0);
+#endif
+    } else {
+        ruckig.def(py::init<>());
+        ruckig.def(py::init<double>(), "delta_time"_a);
+#if defined WITH_CLOUD_CLIENT
+        ruckig.def(py::init<double, size_t>(), "delta_time"_a, "max_number_of_waypoints"_a=0);
+#endif
+    }
+#if defined WITH_CLOUD_CLIENT
+    ruckig.def("filter_intermediate_positions", static_cast<std::vector<StandardVector<double, DOFs>> (Otg::*)(const Input&, const StandardVector<double, DOFs>&) const>(&Otg::filter_intermediate_positions), "input"_a, "threshold_distance"_a);
+#endif
+    ruckig
+        .def_readonly("max_number_of_waypoints", &Otg::max_number_of_waypoints)
+        .def_readonly("degrees_of_freedom", &Otg::degrees_of_freedom)
+        .def_readwrite("delta_time", &Otg::delta_time)
+        .def("reset", &Otg::reset)
+        .def("validate_input", &Otg::template validate_input<true>, "input"_a, "check_current_state_within_limits"_a=false, "check_target_state_within_limits"_a=true)
+        .def("calculate", static_cast<Result (Otg::*)(const Input&, Traj&)>(&Otg::calculate), "input"_a, "trajectory"_a)
+        .def("calculate", static_cast<Result (Otg::*)(const Input&, Traj&, bool&)>(&Otg::calculate), "input"_a, "trajectory"_a, "was_interrupted"_a)
+        .def("update", static_cast<Result (Otg::*)(const Input&, Output&)>(&Otg::update), "input"_a, "output"_a);
+}
+
+//! Create an instance of the statically sized class if available for the number of DoFs, and of the dynamic class otherwise
+template<template<size_t, template<class, size_t> class> class T, class... Args>
+py::object create_for_dofs(size_t dofs, Args... args) {
+    switch (dofs) {
+        case 1: return py::cast(new T<1, StandardVector>(args...), py::return_value_policy::take_ownership);
+        case 2: return py::cast(new T<2, StandardVector>(args...), py::return_value_policy::take_ownership);
+        case 3: return py::cast(new T<3, StandardVector>(args...), py::return_value_policy::take_ownership);
+        case 6: return py::cast(new T<6, StandardVector>(args...), py::return_value_policy::take_ownership);
+        case 7: return py::cast(new T<7, StandardVector>(args...), py::return_value_policy::take_ownership);
+        default: return py::cast(new T<DynamicDOFs, StandardVector>(dofs, args...), py::return_value_policy::take_ownership);
+    }
+}
+
 
 PYBIND11_MODULE(ruckig, m) {
     m.doc() = "Instantaneous Motion Generation for Robots and Machines. Real-time and time-optimal trajectory calculation \
@@ -48,6 +463,22 @@ limited by velocity, acceleration, and jerk constraints.";
 
     py::register_exception<RuckigError>(m, "RuckigError");
 
+    py::enum_<CalculationStage>(m, "CalculationStage")
+        .value("No", CalculationStage::None)
+        .value("Validation", CalculationStage::Validation)
+        .value("Step1", CalculationStage::Step1)
+        .value("Synchronization", CalculationStage::Synchronization)
+        .value("TimeSynchronization", CalculationStage::TimeSynchronization)
+        .value("Continuation", CalculationStage::Continuation);
+
+    py::class_<CalculationError>(m, "CalculationError")
+        .def_readonly("result", &CalculationError::result)
+        .def_readonly("stage", &CalculationError::stage)
+        .def_readonly("dof", &CalculationError::dof)
+        .def_readonly("duration", &CalculationError::duration)
+        .def("has_error", &CalculationError::has_error)
+        .def("__repr__", &CalculationError::to_string);
+
     py::class_<Bound>(m, "Bound")
         .def_readonly("min", &Bound::min)
         .def_readonly("max", &Bound::max)
@@ -57,111 +488,35 @@ limited by velocity, acceleration, and jerk constraints.";
             return "[" + std::to_string(ext.min) + ", " + std::to_string(ext.max) + "]";
         });
 
-    py::class_<Trajectory<DynamicDOFs>>(m, "Trajectory")
-        .def(py::init<size_t>(), "dofs"_a)
-#if defined WITH_CLOUD_CLIENT
-        .def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a)
-#endif
-        .def_readonly("degrees_of_freedom", &Trajectory<DynamicDOFs>::degrees_of_freedom)
-        .def_property_readonly("profiles", &Trajectory<DynamicDOFs>::get_profiles)
-        .def_property_readonly("duration", &Trajectory<DynamicDOFs>::get_duration)
-        .def_property_readonly("intermediate_durations", &Trajectory<DynamicDOFs>::get_intermediate_durations)
-        .def_property_readonly("independent_min_durations", &Trajectory<DynamicDOFs>::get_independent_min_durations)
-        .def_property_readonly("position_extrema", &Trajectory<DynamicDOFs>::get_position_extrema)
-        .def("at_time", [](const Trajectory<DynamicDOFs>& traj, double time, bool return_section=false) {
-            std::vector<double> new_position(traj.degrees_of_freedom), new_velocity(traj.degrees_of_freedom), new_acceleration(traj.degrees_of_freedom), new_jerk(traj.degrees_of_freedom);
-            size_t new_section;
-            traj.at_time(time, new_position, new_velocity, new_acceleration, new_jerk, new_section);
-            if (return_section) {
-                return py::make_tuple(new_position, new_velocity, new_acceleration, new_section);
-            }
-            return py::make_tuple(new_position, new_velocity, new_acceleration);
-        }, "time"_a, "return_section"_a=false)
-        .def("get_first_time_at_position", [](const Trajectory<DynamicDOFs>& traj, size_t dof, double position) -> py::object {
-            double time;
-            if (traj.get_first_time_at_position(dof, position, time)) {
-                return py::cast(time);
-            }
-            return py::none();
-        }, "dof"_a, "position"_a);
+    py::class_<TimeInterval>(m, "TimeInterval")
+        .def_readonly("start", &TimeInterval::start)
+        .def_readonly("end", &TimeInterval::end)
+        .def("__repr__", [](const TimeInterval& interval) {
+            return "[" + std::to_string(interval.start) + ", " + std::to_string(interval.end) + "]";
+        });
 
-    py::class_<InputParameter<DynamicDOFs>>(m, "InputParameter")
-        .def(py::init<size_t>(), "dofs"_a)
-#if defined WITH_CLOUD_CLIENT
-        .def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a)
-#endif
-        .def_readonly("degrees_of_freedom", &InputParameter<DynamicDOFs>::degrees_of_freedom)
-        .def_readwrite("current_position", &InputParameter<DynamicDOFs>::current_position)
-        .def_readwrite("current_velocity", &InputParameter<DynamicDOFs>::current_velocity)
-        .def_readwrite("current_acceleration", &InputParameter<DynamicDOFs>::current_acceleration)
-        .def_readwrite("target_position", &InputParameter<DynamicDOFs>::target_position)
-        .def_readwrite("target_velocity", &InputParameter<DynamicDOFs>::target_velocity)
-        .def_readwrite("target_acceleration", &InputParameter<DynamicDOFs>::target_acceleration)
-        .def_readwrite("max_velocity", &InputParameter<DynamicDOFs>::max_velocity)
-        .def_readwrite("max_acceleration", &InputParameter<DynamicDOFs>::max_acceleration)
-        .def_readwrite("max_jerk", &InputParameter<DynamicDOFs>::max_jerk)
-        .def_readwrite("min_velocity", &InputParameter<DynamicDOFs>::min_velocity)
-        .def_readwrite("min_acceleration", &InputParameter<DynamicDOFs>::min_acceleration)
-        .def_readwrite("intermediate_positions", &InputParameter<DynamicDOFs>::intermediate_positions)
-        .def_readwrite("per_section_max_velocity", &InputParameter<DynamicDOFs>::per_section_max_velocity)
-        .def_readwrite("per_section_max_acceleration", &InputParameter<DynamicDOFs>::per_section_max_acceleration)
-        .def_readwrite("per_section_max_jerk", &InputParameter<DynamicDOFs>::per_section_max_jerk)
-        .def_readwrite("per_section_min_velocity", &InputParameter<DynamicDOFs>::per_section_min_velocity)
-        .def_readwrite("per_section_min_acceleration", &InputParameter<DynamicDOFs>::per_section_min_acceleration)
-        .def_readwrite("per_section_max_position", &InputParameter<DynamicDOFs>::per_section_max_position)
-        .def_readwrite("per_section_min_position", &InputParameter<DynamicDOFs>::per_section_min_position)
-        .def_readwrite("max_position", &InputParameter<DynamicDOFs>::max_position)
-        .def_readwrite("min_position", &InputParameter<DynamicDOFs>::min_position)
-        .def_readwrite("enabled", &InputParameter<DynamicDOFs>::enabled)
-        .def_readwrite("control_interface", &InputParameter<DynamicDOFs>::control_interface)
-        .def_readwrite("synchronization", &InputParameter<DynamicDOFs>::synchronization)
-        .def_readwrite("duration_discretization", &InputParameter<DynamicDOFs>::duration_discretization)
-        .def_readwrite("per_dof_control_interface", &InputParameter<DynamicDOFs>::per_dof_control_interface)
-        .def_readwrite("per_dof_synchronization", &InputParameter<DynamicDOFs>::per_dof_synchronization)
-        .def_readwrite("minimum_duration", &InputParameter<DynamicDOFs>::minimum_duration)
-        .def_readwrite("per_section_minimum_duration", &InputParameter<DynamicDOFs>::per_section_minimum_duration)
-        .def_readwrite("interrupt_calculation_duration", &InputParameter<DynamicDOFs>::interrupt_calculation_duration)
-        .def("validate", &InputParameter<DynamicDOFs>::validate<true>, "check_current_state_within_limits"_a=false, "check_target_state_within_limits"_a=true)
-        .def(py::self != py::self)
-        .def("__repr__", &InputParameter<DynamicDOFs>::to_string);
+    py::class_<KinematicBounds>(m, "KinematicBounds")
+        .def_readonly("position", &KinematicBounds::position)
+        .def_readonly("velocity", &KinematicBounds::velocity)
+        .def_readonly("acceleration", &KinematicBounds::acceleration)
+        .def_readonly("jerk", &KinematicBounds::jerk);
 
-    py::class_<OutputParameter<DynamicDOFs>>(m, "OutputParameter")
-        .def(py::init<size_t>(), "dofs"_a)
-#if defined WITH_CLOUD_CLIENT
-        .def(py::init<size_t, size_t>(), "dofs"_a, "max_number_of_waypoints"_a)
-#endif
-        .def_readonly("degrees_of_freedom", &OutputParameter<DynamicDOFs>::degrees_of_freedom)
-        .def_readonly("new_position", &OutputParameter<DynamicDOFs>::new_position)
-        .def_readonly("new_velocity", &OutputParameter<DynamicDOFs>::new_velocity)
-        .def_readonly("new_acceleration", &OutputParameter<DynamicDOFs>::new_acceleration)
-        .def_readonly("new_section", &OutputParameter<DynamicDOFs>::new_section)
-        .def_readonly("did_section_change", &OutputParameter<DynamicDOFs>::did_section_change)
-        .def_readonly("trajectory", &OutputParameter<DynamicDOFs>::trajectory)
-        .def_readwrite("time", &OutputParameter<DynamicDOFs>::time)
-        .def_readonly("new_calculation", &OutputParameter<DynamicDOFs>::new_calculation)
-        .def_readonly("was_calculation_interrupted", &OutputParameter<DynamicDOFs>::was_calculation_interrupted)
-        .def_readonly("calculation_duration", &OutputParameter<DynamicDOFs>::calculation_duration)
-        .def("pass_to_input", &OutputParameter<DynamicDOFs>::pass_to_input, "input"_a)
-        .def("__repr__", &OutputParameter<DynamicDOFs>::to_string)
-        .def("__copy__",  [](const OutputParameter<DynamicDOFs> &self) {
-            return OutputParameter<DynamicDOFs>(self);
-        });
+    bind_dofs<DynamicDOFs>(m, "");
+    bind_dofs<1>(m, "1");
+    bind_dofs<2>(m, "2");
+    bind_dofs<3>(m, "3");
+    bind_dofs<6>(m, "6");
+    bind_dofs<7>(m, "7");
 
-    py::class_<RuckigThrow<DynamicDOFs>>(m, "Ruckig")
-        .def(py::init<size_t>(), "dofs"_a)
-        .def(py::init<size_t, double>(), "dofs"_a, "delta_time"_a)
-#if defined WITH_CLOUD_CLIENT
-        .def(py::init<size_t, double, size_t>(), "dofs"_a, "delta_time"_a, "max_number_of_waypoints"_a=0)
-        .def("filter_intermediate_positions", &RuckigThrow<DynamicDOFs>::filter_intermediate_positions, "input"_a, "threshold_distance"_a)
-#endif
-        .def_readonly("max_number_of_waypoints", &RuckigThrow<DynamicDOFs>::max_number_of_waypoints)
-        .def_readonly("degrees_of_freedom", &RuckigThrow<DynamicDOFs>::degrees_of_freedom)
-        .def_readwrite("delta_time", &RuckigThrow<DynamicDOFs>::delta_time)
-        .def("reset", &RuckigThrow<DynamicDOFs>::reset)
-        .def("validate_input", &RuckigThrow<DynamicDOFs>::validate_input<true>, "input"_a, "check_current_state_within_limits"_a=false, "check_target_state_within_limits"_a=true)
-        .def("calculate", static_cast<Result (RuckigThrow<DynamicDOFs>::*)(const InputParameter<DynamicDOFs>&, Trajectory<DynamicDOFs>&)>(&RuckigThrow<DynamicDOFs>::calculate), "input"_a, "trajectory"_a)
-        .def("calculate", static_cast<Result (RuckigThrow<DynamicDOFs>::*)(const InputParameter<DynamicDOFs>&, Trajectory<DynamicDOFs>&, bool&)>(&RuckigThrow<DynamicDOFs>::calculate), "input"_a, "trajectory"_a, "was_interrupted"_a)
-        .def("update", static_cast<Result (RuckigThrow<DynamicDOFs>::*)(const InputParameter<DynamicDOFs>&, OutputParameter<DynamicDOFs>&)>(&RuckigThrow<DynamicDOFs>::update), "input"_a, "output"_a);
+    // Factories that dispatch to the statically sized variants if available
+    m.def("create_trajectory", [](size_t dofs) { return create_for_dofs<Trajectory>(dofs); }, "dofs"_a);
+    m.def("create_input_parameter", [](size_t dofs) { return create_for_dofs<InputParameter>(dofs); }, "dofs"_a);
+    m.def("create_output_parameter", [](size_t dofs) { return create_for_dofs<OutputParameter>(dofs); }, "dofs"_a);
+    m.def("create_ruckig", [](size_t dofs, std::optional<double> delta_time) {
+        return delta_time ? create_for_dofs<RuckigThrow>(dofs, delta_time.value()) : create_for_dofs<RuckigThrow>(dofs);
+    }, "dofs"_a, "delta_time"_a=py::none());
+
+    m.def("calculate_many", &calculate_many, "current_position"_a, "target_position"_a, "max_velocity"_a, "max_acceleration"_a, "max_jerk"_a, py::kw_only(), "current_velocity"_a=py::none(), "current_acceleration"_a=py::none(), "target_velocity"_a=py::none(), "target_acceleration"_a=py::none(), "number_of_samples"_a=0, "number_of_threads"_a=0);
 
     py::class_<BrakeProfile>(m, "BrakeProfile")
         .def_readonly("duration", &BrakeProfile::duration)
@@ -1,6 +1,9 @@
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
 
 #include <ruckig/ruckig.hpp>
 
@@ -16,9 +19,116 @@ struct TrajectoryState {
     std::vector<double> jerk;
 };
 
+//! Is the typed array a view into the linear memory of the module?
+bool is_module_memory(const em::val& array) {
+    // The memory buffer might change if the memory grows, so get it for every call
+    const em::val memory_buffer = em::val(em::typed_memory_view(0, static_cast<const double*>(nullptr)))["buffer"];
+    return array["buffer"].strictlyEquals(memory_buffer);
+}
+
+//! Sample the trajectory into a Float64Array, directly if it is a view into the linear memory of the module
+bool sample_into(const Trajectory<DynamicDOFs>& traj, em::val array, double t0, double dt, size_t n) {
+    const size_t size = 3 * n * traj.degrees_of_freedom;
+    if (array["length"].as<size_t>() < size) {
+        return false;
+    }
+
+    if (is_module_memory(array)) {
+        traj.sample_into(reinterpret_cast<double*>(array["byteOffset"].as<uintptr_t>()), t0, dt, n);
+        return true;
+    }
+
+    thread_local std::vector<double> buffer;
+    buffer.resize(size);
+    traj.sample_into(buffer.data(), t0, dt, n);
+    array.call<void>("set", em::val(em::typed_memory_view(size, buffer.data())));
+    return true;
+}
+
+//! @brief Calculate a batch of independent trajectories from a flat Float64Array
+//!
+//! Each problem is given by 9 * dofs values: the current position, velocity, and acceleration, the target position,
+//! velocity, and acceleration, and the maximum velocity, acceleration, and jerk. For each problem, the result and the
+//! duration are written to the outputs, which need to hold 2 * n values. Returns the number of problems n, or -1 if
+//! the array sizes do not match. Arrays within the linear memory of the module are accessed in place, others (e.g. on
+//! a SharedArrayBuffer) are copied once per batch.
+int calculate_batch(em::val inputs, em::val outputs, size_t dofs) {
+    const size_t input_size = inputs["length"].as<size_t>();
+    const size_t problem_size = 9 * dofs;
+    if (dofs == 0 || input_size % problem_size != 0) {
+        return -1;
+    }
+
+    const size_t n = input_size / problem_size;
+    if (outputs["length"].as<size_t>() < 2 * n) {
+        return -1;
+    }
+
+    thread_local std::vector<double> input_buffer, output_buffer;
+    const double* input_data;
+    if (is_module_memory(inputs)) {
+        input_data = reinterpret_cast<const double*>(inputs["byteOffset"].as<uintptr_t>());
+    } else {
+        input_buffer.resize(input_size);
+        em::val(em::typed_memory_view(input_size, input_buffer.data())).call<void>("set", inputs);
+        input_data = input_buffer.data();
+    }
+
+    const bool is_output_in_module_memory = is_module_memory(outputs);
+    double* output_data;
+    if (is_output_in_module_memory) {
+        output_data = reinterpret_cast<double*>(outputs["byteOffset"].as<uintptr_t>());
+    } else {
+        output_buffer.resize(2 * n);
+        output_data = output_buffer.data();
+    }
+
+    Ruckig<DynamicDOFs> otg {dofs};
+    InputParameter<DynamicDOFs> input {dofs};
+    Trajectory<DynamicDOFs> trajectory {dofs};
+    for (size_t i = 0; i < n; ++i) {
+        const double* problem = input_data + i * problem_size;
+        for (size_t dof = 0; dof < dofs; ++dof) {
+            input.current_position[dof] = problem[dof];
+            input.current_velocity[dof] = problem[dofs + dof];
+            input.current_acceleration[dof] = problem[2 * dofs + dof];
+            input.target_position[dof] = problem[3 * dofs + dof];
+            input.target_velocity[dof] = problem[4 * dofs + dof];
+            input.target_acceleration[dof] = problem[5 * dofs + dof];
+            input.max_velocity[dof] = problem[6 * dofs + dof];
+            input.max_acceleration[dof] = problem[7 * dofs + dof];
+            input.max_jerk[dof] = problem[8 * dofs + dof];
+        }
+
+        const Result result = otg.calculate(input, trajectory);
+        const bool is_valid = (result == Result::Working || result == Result::ErrorPositionalLimits);
+        output_data[2 * i] = static_cast<double>(result);
+        output_data[2 * i + 1] = is_valid ? trajectory.get_duration() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (!is_output_in_module_memory) {
+        outputs.call<void>("set", em::val(em::typed_memory_view(2 * n, output_data)));
+    }
+    return static_cast<int>(n);
+}
+
 
 EMSCRIPTEN_BINDINGS(ruckig) {
     em::register_vector<double>("Vector");
+    em::register_vector<Bound>("BoundVector");
+    em::register_vector<KinematicBounds>("KinematicBoundsVector");
+
+    em::value_object<Bound>("Bound")
+        .field("min", &Bound::min)
+        .field("max", &Bound::max)
+        .field("t_min", &Bound::t_min)
+        .field("t_max", &Bound::t_max);
+
+    em::value_object<KinematicBounds>("KinematicBounds")
+        .field("position", &KinematicBounds::position)
+        .field("velocity", &KinematicBounds::velocity)
+        .field("acceleration", &KinematicBounds::acceleration)
+        .field("jerk", &KinematicBounds::jerk);
 
     em::enum_<ControlInterface>("ControlInterface")
         .value("Position", ControlInterface::Position)
@@ -43,6 +153,8 @@ EMSCRIPTEN_BINDINGS(ruckig) {
         .value("ErrorExecutionTimeCalculation", Result::ErrorExecutionTimeCalculation)
         .value("ErrorSynchronizationCalculation", Result::ErrorSynchronizationCalculation);
 
+    em::function("calculate_batch", &calculate_batch);
+
     em::class_<TrajectoryState>("TrajectoryState")
         .property("section", &TrajectoryState::section)
         .property("position", &TrajectoryState::position)
@@ -57,6 +169,10 @@ EMSCRIPTEN_BINDINGS(ruckig) {
         .function("get_intermediate_durations", &Trajectory<DynamicDOFs>::get_intermediate_durations)
         .function("get_independent_min_durations", &Trajectory<DynamicDOFs>::get_independent_min_durations)
         .function("get_position_extrema", &Trajectory<DynamicDOFs>::get_position_extrema)
+        .function("get_velocity_extrema", &Trajectory<DynamicDOFs>::get_velocity_extrema)
+        .function("get_acceleration_extrema", &Trajectory<DynamicDOFs>::get_acceleration_extrema)
+        .function("get_jerk_extrema", &Trajectory<DynamicDOFs>::get_jerk_extrema)
+        .function("get_section_extrema", &Trajectory<DynamicDOFs>::get_section_extrema)
         .function("at_time", em::select_overload<TrajectoryState(const Trajectory<DynamicDOFs>&, double)>([](const Trajectory<DynamicDOFs>& traj, double time) {
             TrajectoryState result;
             result.position.resize(traj.degrees_of_freedom);
@@ -65,7 +181,8 @@ EMSCRIPTEN_BINDINGS(ruckig) {
             result.jerk.resize(traj.degrees_of_freedom);
             traj.at_time(time, result.position, result.velocity, result.acceleration, result.jerk, result.section);
             return result;
-        }));
+        }))
+        .function("sample_into", &sample_into);
 
     em::class_<InputParameter<DynamicDOFs>>("InputParameter")
         .constructor<size_t>()
@@ -1,13 +1,22 @@
 #define DOCTEST_CONFIG_IMPLEMENT
 #include <doctest/doctest.h>
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <random>
 #include <optional>
+#include <thread>
 #include "randomizer.hpp"
 
+#include <ruckig/calculator_group.hpp>
+#include <ruckig/calculator_stop.hpp>
 #include <ruckig/error.hpp>
 #include <ruckig/ruckig.hpp>
+#include <ruckig/shared_output_stream.hpp>
+#include <ruckig/trajectory_handoff.hpp>
+#include <ruckig/trajectory_library.hpp>
+#include <ruckig/trajectory_view.hpp>
 
 
 using namespace ruckig;
@@ -235,6 +244,21 @@ TEST_CASE("trajectory") {
         CHECK( new_section == 1 );
     }
 
+    SUBCASE("sample-into") {
+        std::array<double, 3 * 3 * 5> new_states;
+        output.trajectory.sample_into(new_states.data(), 0.5, 1.0, 5);
+
+        std::array<double, 3> new_position, new_velocity, new_acceleration;
+        for (size_t i = 0; i < 5; ++i) {
+            output.trajectory.at_time(0.5 + i * 1.0, new_position, new_velocity, new_acceleration);
+            for (size_t dof = 0; dof < 3; ++dof) {
+                CHECK( new_states[9 * i + dof] == doctest::Approx(new_position[dof]) );
+                CHECK( new_states[9 * i + 3 + dof] == doctest::Approx(new_velocity[dof]) );
+                CHECK( new_states[9 * i + 6 + dof] == doctest::Approx(new_acceleration[dof]) );
+            }
+        }
+    }
+
     SUBCASE("at-time-single-dof") {
         RuckigThrow<1> otg {0.005};
         InputParameter<1> input;
@@ -289,6 +313,102 @@ TEST_CASE("trajectory") {
         CHECK( position_extrema[2].min == doctest::Approx(0.0) );
     }
 
+    SUBCASE("kinematic-extrema") {
+        const auto velocity_extrema = output.trajectory.get_velocity_extrema();
+        CHECK( velocity_extrema[2].max == doctest::Approx(1.0) );
+        CHECK( velocity_extrema[2].t_max == doctest::Approx(2.0) );
+        CHECK( velocity_extrema[2].min == doctest::Approx(0.0) );
+
+        const auto acceleration_extrema = output.trajectory.get_acceleration_extrema();
+        CHECK( acceleration_extrema[2].max == doctest::Approx(1.0) );
+        CHECK( acceleration_extrema[2].t_max == doctest::Approx(1.0) );
+        CHECK( acceleration_extrema[2].min == doctest::Approx(-1.0) );
+        CHECK( acceleration_extrema[2].t_min == doctest::Approx(3.0) );
+
+        const auto jerk_extrema = output.trajectory.get_jerk_extrema();
+        CHECK( jerk_extrema[2].max == doctest::Approx(1.0) );
+        CHECK( jerk_extrema[2].min == doctest::Approx(-1.0) );
+
+        // All sampled states need to lie within the extrema, which are reached at their times
+        const auto section_extrema = output.trajectory.get_section_extrema(0);
+        std::array<double, 3> new_position, new_velocity, new_acceleration, new_jerk;
+        size_t new_section;
+        for (double t = 0.0; t <= output.trajectory.get_duration(); t += 0.01) {
+            output.trajectory.at_time(t, new_position, new_velocity, new_acceleration, new_jerk, new_section);
+            for (size_t dof = 0; dof < 3; ++dof) {
+                CHECK( new_velocity[dof] <= velocity_extrema[dof].max + 1e-12 );
+                CHECK( new_velocity[dof] >= velocity_extrema[dof].min - 1e-12 );
+                CHECK( new_acceleration[dof] <= acceleration_extrema[dof].max + 1e-12 );
+                CHECK( new_acceleration[dof] >= acceleration_extrema[dof].min - 1e-12 );
+                CHECK( new_jerk[dof] <= jerk_extrema[dof].max );
+                CHECK( new_jerk[dof] >= jerk_extrema[dof].min );
+            }
+        }
+
+        for (size_t dof = 0; dof < 3; ++dof) {
+            output.trajectory.at_time(velocity_extrema[dof].t_max, new_position, new_velocity, new_acceleration);
+            CHECK( new_velocity[dof] == doctest::Approx(velocity_extrema[dof].max) );
+            output.trajectory.at_time(velocity_extrema[dof].t_min, new_position, new_velocity, new_acceleration);
+            CHECK( new_velocity[dof] == doctest::Approx(velocity_extrema[dof].min) );
+
+            CHECK( section_extrema[dof].position.max == doctest::Approx(output.trajectory.get_position_extrema()[dof].max) );
+            CHECK( section_extrema[dof].velocity.min == doctest::Approx(velocity_extrema[dof].min) );
+        }
+
+        // The cached extrema are recalculated with the trajectory
+        Trajectory<3> copy {output.trajectory};
+        CHECK( copy.get_velocity_extrema()[2].max == doctest::Approx(1.0) );
+
+        input.target_position = {1.0, -3.0, 4.0};
+        otg.calculate(input, copy);
+        CHECK( copy.get_position_extrema()[2].max == doctest::Approx(4.0) );
+        CHECK( output.trajectory.get_position_extrema()[2].max == doctest::Approx(2.0) );
+    }
+
+    SUBCASE("swept-position-bounds") {
+        const auto bounds = output.trajectory.get_swept_position_bounds({0.0, 2.0, 4.0, 5.0});
+        CHECK( bounds.size() == 3 );
+        CHECK( bounds[0][0].min == doctest::Approx(0.0) );
+        CHECK( bounds[0][0].max == doctest::Approx(0.5) );
+        CHECK( bounds[1][0].min == doctest::Approx(0.5) );
+        CHECK( bounds[1][0].max == doctest::Approx(1.0) );
+        CHECK( bounds[1][1].min == doctest::Approx(-3.1549193338) );
+        CHECK( bounds[1][1].t_min == doctest::Approx(3.2254033308) );
+        CHECK( bounds[2][2].min == doctest::Approx(2.0) );
+        CHECK( bounds[2][2].max == doctest::Approx(2.0) );
+
+        const auto window_bounds = output.trajectory.get_position_bounds(1.0, 1.5);
+        std::array<double, 3> new_position, new_velocity, new_acceleration;
+        output.trajectory.at_time(1.5, new_position, new_velocity, new_acceleration);
+        CHECK( window_bounds[2].max == doctest::Approx(new_position[2]) );
+        CHECK( window_bounds[2].t_max == doctest::Approx(1.5) );
+
+        // Every sampled position needs to lie within the box of its phase
+        const auto phase_bounds = output.trajectory.get_swept_position_bounds();
+        CHECK( phase_bounds.size() > 3 );
+        const auto position_extrema = output.trajectory.get_position_extrema();
+        for (size_t dof = 0; dof < 3; ++dof) {
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+            for (const auto& box: phase_bounds) {
+                min = std::min(min, box[dof].min);
+                max = std::max(max, box[dof].max);
+            }
+            CHECK( min == doctest::Approx(position_extrema[dof].min) );
+            CHECK( max == doctest::Approx(position_extrema[dof].max) );
+        }
+
+        const auto partition_bounds = output.trajectory.get_swept_position_bounds({0.0, 0.4, 0.8, 1.2, 1.6, 2.0, 2.4, 2.8, 3.2, 3.6, 4.0});
+        for (double t = 0.0; t < 4.0; t += 0.01) {
+            const auto& box = partition_bounds[static_cast<size_t>(t / 0.4)];
+            output.trajectory.at_time(t, new_position, new_velocity, new_acceleration);
+            for (size_t dof = 0; dof < 3; ++dof) {
+                CHECK( new_position[dof] >= box[dof].min - 1e-9 );
+                CHECK( new_position[dof] <= box[dof].max + 1e-9 );
+            }
+        }
+    }
+
     SUBCASE("first-time-at-position") {
         CHECK( output.trajectory.get_first_time_at_position(0, 0.0).value() == doctest::Approx(0.0) );
         CHECK( output.trajectory.get_first_time_at_position(0, 0.5).value() == doctest::Approx(2.0) );
@@ -302,6 +422,33 @@ TEST_CASE("trajectory") {
         CHECK_FALSE( output.trajectory.get_first_time_at_position(6, 0.0) );
     }
 
+    SUBCASE("time-intervals-within-position") {
+        auto intervals = output.trajectory.get_time_intervals_within_position(0, 0.5, 2.0);
+        CHECK( intervals.size() == 1 );
+        CHECK( intervals[0].start == doctest::Approx(2.0) );
+        CHECK( intervals[0].end == doctest::Approx(4.0) );
+
+        intervals = output.trajectory.get_time_intervals_within_position(1, -3.1, -3.0);
+        CHECK( intervals.size() == 2 );
+        CHECK( intervals[0].start == doctest::Approx(2.6004877902) );
+        CHECK( intervals[0].end == doctest::Approx(2.8644154489) );
+        CHECK( intervals[1].end == doctest::Approx(4.0) );
+
+        std::array<double, 3> new_position, new_velocity, new_acceleration;
+        output.trajectory.at_time(intervals[1].start, new_position, new_velocity, new_acceleration);
+        CHECK( new_position[1] == doctest::Approx(-3.1) );
+
+        CHECK( output.trajectory.get_time_intervals_within_position(0, 2.0, 3.0).empty() );
+        CHECK( output.trajectory.get_time_intervals_within_position(2, -1.0, 3.0).size() == 1 );
+
+        const auto box_intervals = output.trajectory.get_time_intervals_within_box({0.5, -3.1, 1.0}, {2.0, -3.0, 3.0});
+        CHECK( box_intervals.size() == 2 );
+        CHECK( box_intervals[0].start == doctest::Approx(intervals[0].start) );
+        CHECK( box_intervals[1].start == doctest::Approx(intervals[1].start) );
+
+        CHECK( output.trajectory.get_time_intervals_within_box({0.5, -3.1, 1.0}, {2.0, -3.0, 1.5}).empty() );
+    }
+
     input.current_position = {0.0, -2.0, 0.0};
     input.current_velocity = {0.0, 0.0, 0.0};
     input.current_acceleration = {0.0, 0.0, 0.0};
@@ -433,6 +580,28 @@ TEST_CASE("input-validation") {
     input.target_acceleration = {0.0, -0.0001};
     CHECK_THROWS_WITH_AS( otg.validate_input(input), doctest::Contains("will exceed its maximum velocity"), RuckigError);
     CHECK_FALSE( otg.validate_input<false>(input) );
+    CHECK_FALSE( input.is_state_valid() );
+    CHECK( input.is_state_valid(false, false) );
+
+    // The limits are validated only if they changed since the last calculation
+    Ruckig<2> otg_cached;
+    Trajectory<2> trajectory;
+    input.target_velocity = {0.0, 0.3};
+    input.target_acceleration = {0.0, 0.0};
+    CHECK( otg_cached.calculate(input, trajectory) == Result::Working );
+
+    input.max_jerk = {1.0, nan};
+    CHECK( otg_cached.calculate(input, trajectory) == Result::ErrorInvalidInput );
+
+    input.max_jerk = {1.0, 1.0};
+    CHECK( otg_cached.calculate(input, trajectory) == Result::Working );
+
+    input.current_position = {1.0, nan};
+    CHECK( otg_cached.calculate(input, trajectory) == Result::ErrorInvalidInput );
+
+    input.current_position = {1.0, 1.0};
+    input.target_velocity = {0.0, 1.3};
+    CHECK( otg_cached.calculate(input, trajectory) == Result::ErrorInvalidInput );
 }
 
 TEST_CASE("enabled") {
@@ -524,6 +693,9 @@ TEST_CASE("phase-synchronization") {
     CHECK( array_eq(new_position, {0.8333333333, -2.0833333333, 0.1666666667}) );
     CHECK( array_eq(output.trajectory.get_profiles()[0][0].t, output.trajectory.get_profiles()[0][1].t) );
     CHECK( array_eq(output.trajectory.get_profiles()[0][0].t, output.trajectory.get_profiles()[0][2].t) );
+    CHECK( output.trajectory.get_profiles()[0][1].p.back() == doctest::Approx(-3.0) );
+    CHECK( output.trajectory.get_profiles()[0][2].p.back() == doctest::Approx(2.0) );
+    CHECK( output.trajectory.get_profiles()[0][2].j[0] == doctest::Approx(0.2 * output.trajectory.get_profiles()[0][0].j[0]) );
 
     // Test equal start and target state
     input.current_position = {1.0, -2.0, 3.0};
@@ -638,6 +810,12 @@ TEST_CASE("discretization") {
     result = otg.update(input, output);
     output.trajectory.at_time(4.5, new_position, new_velocity, new_acceleration);
     CHECK( array_eq(new_position, {1.0, -3.0, 2.0}) );
+
+    // A duration that is a multiple of the control cycle is kept
+    input.minimum_duration = 5.0;
+    result = otg.calculate(input, traj);
+    CHECK( result == Result::Working );
+    CHECK( traj.get_duration() == doctest::Approx(5.0) );
 }
 
 TEST_CASE("per-dof-setting") {
@@ -799,6 +977,707 @@ TEST_CASE("dynamic-dofs") {
     CHECK( array_eq(new_acceleration, input.current_acceleration) );
 }
 
+TEST_CASE("filter-intermediate-positions") {
+    Ruckig<2> otg;
+    InputParameter<2> input;
+    input.current_position = {0.0, 0.0};
+    input.target_position = {4.0, 0.0};
+    input.intermediate_positions = {
+        {1.0, 0.05},
+        {2.0, 0.0},
+        {3.0, 0.5},
+        {3.5, 0.0},
+    };
+
+    const auto filtered_positions = otg.filter_intermediate_positions(input, {0.1, 0.1});
+    CHECK( filtered_positions.size() == 3 );
+    CHECK( array_eq(filtered_positions[0], {2.0, 0.0}) );
+    CHECK( array_eq(filtered_positions[1], {3.0, 0.5}) );
+    CHECK( array_eq(filtered_positions[2], {3.5, 0.0}) );
+
+    std::array<std::array<double, 2>, 4> buffer;
+    auto end = otg.filter_intermediate_positions(input, {0.1, 0.1}, buffer.begin());
+    CHECK( std::distance(buffer.begin(), end) == 3 );
+    CHECK( array_eq(buffer[1], {3.0, 0.5}) );
+
+    // A high threshold removes all intermediate positions
+    CHECK( otg.filter_intermediate_positions(input, {1.0, 1.0}).empty() );
+
+    // Duplicate positions (zero-length segments in all DoFs)
+    input.intermediate_positions = {
+        {0.0, 0.0},
+        {0.0, 0.0},
+        {4.0, 0.0},
+    };
+    CHECK( otg.filter_intermediate_positions(input, {0.1, 0.1}).empty() );
+}
+
+TEST_CASE("waypoint-queue") {
+    WaypointQueue<2> waypoints {3, 1};
+    CHECK( waypoints.push({1.0, 0.0}) );
+    CHECK( waypoints.push({2.0, 0.0}) );
+    CHECK( waypoints.push({3.0, 0.0}) );
+    CHECK_FALSE( waypoints.push({4.0, 0.0}) );
+    CHECK( waypoints.full() );
+
+    InputParameter<2> input;
+    waypoints.write_to_input(input);
+    CHECK( input.intermediate_positions.size() == 1 );
+    CHECK( array_eq(input.intermediate_positions[0], {1.0, 0.0}) );
+    CHECK( array_eq(input.target_position, {2.0, 0.0}) );
+
+    OutputParameter<2> output;
+    output.new_position = {0.5, 0.0};
+    output.new_velocity = {0.0, 0.0};
+    output.new_acceleration = {0.0, 0.0};
+    output.did_section_change = true;
+    output.pass_to_input(input, waypoints);
+    CHECK( waypoints.size() == 2 );
+    CHECK( array_eq(input.current_position, {0.5, 0.0}) );
+    CHECK( array_eq(input.intermediate_positions[0], {2.0, 0.0}) );
+    CHECK( array_eq(input.target_position, {3.0, 0.0}) );
+
+    // The ring buffer wraps around
+    CHECK( waypoints.push({4.0, 0.0}) );
+    CHECK( array_eq(waypoints[2], {4.0, 0.0}) );
+
+    // Growing the window reuses the reserved intermediate positions
+    WaypointQueue<2> window_waypoints {4, 2};
+    window_waypoints.push({1.0, 0.0});
+    InputParameter<2> window_input;
+    window_waypoints.write_to_input(window_input);
+    CHECK( window_input.intermediate_positions.empty() );
+    CHECK( window_input.intermediate_positions.capacity() >= 2 );
+
+    const auto* reserved_positions = window_input.intermediate_positions.data();
+    window_waypoints.push({2.0, 0.0});
+    window_waypoints.push({3.0, 0.0});
+    window_waypoints.write_to_input(window_input);
+    CHECK( window_input.intermediate_positions.size() == 2 );
+    CHECK( window_input.intermediate_positions.data() == reserved_positions );
+
+    // Stream waypoints one by one into targets without intermediate positions
+    Ruckig<2> otg {0.01};
+    WaypointQueue<2> targets {2, 0};
+    targets.push({1.0, 0.5});
+    targets.push({2.0, -0.5});
+
+    InputParameter<2> stream_input;
+    stream_input.max_velocity = {1.0, 1.0};
+    stream_input.max_acceleration = {1.0, 1.0};
+    stream_input.max_jerk = {1.0, 1.0};
+    targets.write_to_input(stream_input);
+    CHECK( stream_input.intermediate_positions.empty() );
+
+    bool pushed_last_target {false};
+    Result result {Result::Working};
+    while (result == Result::Working || !targets.empty()) {
+        result = otg.update(stream_input, output);
+        CHECK( result != Result::Error );
+        output.pass_to_input(stream_input, targets);
+
+        if (targets.size() == 1 && !pushed_last_target) {
+            CHECK( targets.push({3.0, 0.0}) );
+            pushed_last_target = true;
+        }
+    }
+
+    CHECK( pushed_last_target );
+    CHECK( array_eq(output.new_position, {3.0, 0.0}) );
+}
+
+TEST_CASE("interrupt-calculation") {
+    Ruckig<3, StandardVector, true> otg {0.005};
+    InputParameter<3> input;
+    Trajectory<3> trajectory, interrupted_trajectory;
+
+    input.current_position = {0.0, -2.0, 0.0};
+    input.current_velocity = {0.2, 0.0, -0.3};
+    input.target_position = {1.0, -3.0, 2.0};
+    input.target_velocity = {0.0, 0.3, 0.0};
+    input.max_velocity = {1.0, 1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0, 1.0};
+    input.max_jerk = {1.0, 1.0, 1.0};
+
+    bool was_interrupted {false};
+    CHECK( otg.calculate(input, trajectory, was_interrupted) == Result::Working );
+    CHECK_FALSE( was_interrupted );
+    CHECK_THROWS( otg.continue_calculation(input, trajectory, was_interrupted) );
+
+    input.interrupt_calculation_duration = 0.0;
+    CHECK( otg.calculate(input, interrupted_trajectory, was_interrupted) == Result::Working );
+    CHECK( was_interrupted );
+
+    size_t number_of_continuations {0};
+    while (was_interrupted) {
+        CHECK( otg.continue_calculation(input, interrupted_trajectory, was_interrupted) == Result::Working );
+        number_of_continuations += 1;
+    }
+    CHECK( number_of_continuations >= 1 );
+    CHECK( number_of_continuations <= 5 );
+    CHECK( interrupted_trajectory.get_duration() == doctest::Approx(trajectory.get_duration()) );
+
+    std::array<double, 3> new_position, interrupted_position;
+    for (const double time: {0.5, 1.5, 3.0}) {
+        trajectory.at_time(time, new_position);
+        interrupted_trajectory.at_time(time, interrupted_position);
+        CHECK( array_eq(new_position, interrupted_position) );
+    }
+
+    // Calculate without the interruption flag always finishes the calculation
+    Trajectory<3> completed_trajectory;
+    CHECK( otg.calculate(input, completed_trajectory) == Result::Working );
+    CHECK( completed_trajectory.get_duration() == doctest::Approx(trajectory.get_duration()) );
+    completed_trajectory.at_time(1.5, interrupted_position);
+    trajectory.at_time(1.5, new_position);
+    CHECK( array_eq(new_position, interrupted_position) );
+
+    // Update always finishes the calculation
+    OutputParameter<3> output;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK_FALSE( output.was_calculation_interrupted );
+    CHECK( output.trajectory.get_duration() == doctest::Approx(trajectory.get_duration()) );
+}
+
+TEST_CASE("binary-trajectory") {
+    RuckigThrow<3> otg;
+    InputParameter<3> input;
+    Trajectory<3> traj;
+
+    input.current_position = {0.0, -2.0, 0.0};
+    input.current_velocity = {0.2, 0.0, 0.0};
+    input.current_acceleration = {0.0, 0.0, 2.0};
+    input.target_position = {1.0, -3.0, 2.0};
+    input.target_velocity = {0.0, 0.3, 0.0};
+    input.max_velocity = {1.0, 1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0, 1.0};
+    input.max_jerk = {1.0, 1.0, 1.0};
+
+    CHECK( otg.calculate(input, traj) == Result::Working );
+
+    auto buffer = TrajectoryView<3>::write(traj);
+    const size_t size = TrajectoryView<3>::get_binary_size(traj);
+
+    TrajectoryView<3> view {buffer.data(), size};
+    CHECK( view.is_valid() );
+    CHECK( view.get_duration() == traj.get_duration() );
+    CHECK( view.get_number_of_sections() == traj.get_intermediate_durations().size() );
+    CHECK( view.get_independent_min_duration(2) == traj.get_independent_min_durations()[2] );
+
+    std::array<double, 3> new_position {}, new_velocity {}, new_acceleration {}, new_jerk {};
+    std::array<double, 3> view_position {}, view_velocity {}, view_acceleration {}, view_jerk {};
+    size_t new_section, view_section;
+    for (double t: {0.0, 0.5, 1.7, 3.3, traj.get_duration(), traj.get_duration() + 1.0}) {
+        traj.at_time(t, new_position, new_velocity, new_acceleration, new_jerk, new_section);
+        view.at_time(t, view_position, view_velocity, view_acceleration, view_jerk, view_section);
+        CHECK( new_position == view_position );
+        CHECK( new_velocity == view_velocity );
+        CHECK( new_acceleration == view_acceleration );
+        CHECK( new_jerk == view_jerk );
+        CHECK( new_section == view_section );
+    }
+
+    TrajectoryView<DynamicDOFs> dynamic_view {buffer.data(), size};
+    CHECK( dynamic_view.degrees_of_freedom == 3 );
+
+    CHECK_FALSE( TrajectoryView<2>().load<false>(buffer.data(), size) );
+    CHECK_FALSE( TrajectoryView<3>().load<false>(buffer.data(), size - 8) );
+    CHECK_THROWS_AS( TrajectoryView<3>(buffer.data(), sizeof(BinaryTrajectoryHeader) - 1), RuckigError );
+
+    // Corrupt a single byte of the payload
+    reinterpret_cast<unsigned char*>(buffer.data())[sizeof(BinaryTrajectoryHeader) + 17] ^= 0x01;
+    CHECK_FALSE( TrajectoryView<3>().load<false>(buffer.data(), size) );
+    CHECK( TrajectoryView<3>().load<false>(buffer.data(), size, false) );
+
+    // Corrupt a single byte of the header
+    reinterpret_cast<unsigned char*>(buffer.data())[10] ^= 0x01;
+    CHECK_FALSE( TrajectoryView<3>().load<false>(buffer.data(), size, false) );
+
+    // Crafted header whose payload size overflows, so that it matches a large buffer. Only the header is read.
+    if constexpr (sizeof(size_t) >= 8) {
+        BinaryTrajectoryHeader header;
+        std::memcpy(&header, TrajectoryView<3>::write(traj).data(), sizeof(BinaryTrajectoryHeader));
+        header.degrees_of_freedom = uint64_t {1} << 32;
+        header.number_of_sections = uint64_t {1} << 32;
+        header.payload_size = BinaryTrajectoryHeader::get_payload_size(header.degrees_of_freedom, header.number_of_sections);
+        header.header_checksum = BinaryTrajectoryHeader::checksum(&header, offsetof(BinaryTrajectoryHeader, header_checksum));
+        CHECK( header.payload_size == uint64_t {1} << 36 );
+        CHECK_FALSE( TrajectoryView<DynamicDOFs>().load<false>(&header, size_t {1} << 37, false) );
+    }
+}
+
+TEST_CASE("trajectory-library") {
+    RuckigThrow<3> otg;
+    InputParameter<3> input;
+    Trajectory<3> traj;
+
+    input.max_velocity = {1.0, 1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0, 1.0};
+    input.max_jerk = {1.0, 1.0, 1.0};
+
+    TrajectoryLibrary<3> library;
+    for (double x: {-1.0, 0.0, 1.0}) {
+        for (double y: {-1.0, 0.0, 1.0}) {
+            input.current_position = {x, y, 0.0};
+            input.target_position = {x + 1.0, y - 1.0, 2.0};
+            CHECK( otg.calculate(input, traj) == Result::Working );
+            library.add(input, traj);
+        }
+    }
+    library.build();
+    CHECK( library.size() == 9 );
+
+    // Query close to the entry at (0.0, 1.0)
+    input.current_position = {0.05, 0.95, 0.0};
+    input.target_position = {1.05, -0.05, 2.0};
+
+    const auto entry = library.find_nearest(input);
+    CHECK( entry.has_value() );
+    CHECK( library.get_trajectory(*entry).get_duration() == doctest::Approx(4.0) );
+
+    bool found_in_library;
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK( found_in_library );
+    CHECK( traj.get_duration() == library.get_trajectory(*entry).get_duration() );
+
+    std::array<double, 3> new_position, new_velocity, new_acceleration;
+    traj.at_time(traj.get_duration(), new_position, new_velocity, new_acceleration);
+    CHECK( array_eq(new_position, input.target_position) );
+    CHECK( array_eq(new_velocity, input.target_velocity) );
+
+    // A farther target is not reachable within the stored duration
+    input.target_position = {3.0, -0.05, 2.0};
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK_FALSE( found_in_library );
+    CHECK( traj.get_duration() > 4.0 );
+
+    // An interrupted fallback calculation is completed
+    input.interrupt_calculation_duration = 0.0;
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK_FALSE( found_in_library );
+    traj.at_time(traj.get_duration(), new_position, new_velocity, new_acceleration);
+    CHECK( array_eq(new_position, input.target_position) );
+    input.interrupt_calculation_duration = std::nullopt;
+
+    // The re-timed duration respects the minimum duration and the duration discretization
+    input.target_position = {1.05, -0.05, 2.0};
+    input.minimum_duration = 4.5;
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK( found_in_library );
+    CHECK( traj.get_duration() == doctest::Approx(4.5) );
+
+    input.minimum_duration = std::nullopt;
+    input.duration_discretization = DurationDiscretization::Discrete;
+    CHECK( library.calculate(input, traj, found_in_library) == Result::ErrorInvalidInput );
+
+    library.delta_time = 0.3;
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK( found_in_library );
+    CHECK( traj.get_duration() == doctest::Approx(4.2) );
+
+    input.target_position = {3.0, -0.05, 2.0};
+    CHECK( library.calculate(input, traj, found_in_library) == Result::Working );
+    CHECK_FALSE( found_in_library );
+    CHECK( traj.get_duration() / 0.3 == doctest::Approx(std::round(traj.get_duration() / 0.3)) );
+
+    TrajectoryLibrary<3> empty_library;
+    CHECK_FALSE( empty_library.find_nearest(input).has_value() );
+
+    InputParameter<DynamicDOFs> dynamic_input {3};
+    dynamic_input.max_velocity = {1.0, 1.0, 1.0};
+    dynamic_input.max_acceleration = {1.0, 1.0, 1.0};
+    dynamic_input.max_jerk = {1.0, 1.0, 1.0};
+    dynamic_input.target_position = {1.0, -1.0, 2.0};
+    Trajectory<DynamicDOFs> dynamic_traj {3};
+    RuckigThrow<DynamicDOFs> dynamic_otg {3};
+    CHECK( dynamic_otg.calculate(dynamic_input, dynamic_traj) == Result::Working );
+
+    TrajectoryLibrary<DynamicDOFs> dynamic_library {3};
+    dynamic_library.add(dynamic_input, dynamic_traj);
+    dynamic_library.build();
+    CHECK( dynamic_library.find_nearest(dynamic_input) == 0 );
+}
+
+TEST_CASE("shared-output-stream") {
+    RuckigThrow<3> otg {0.01};
+    InputParameter<3> input;
+    OutputParameter<3> output;
+
+    input.current_position = {0.0, -2.0, 0.0};
+    input.target_position = {1.0, -3.0, 2.0};
+    input.max_velocity = {1.0, 1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0, 1.0};
+    input.max_jerk = {1.0, 1.0, 1.0};
+
+    auto stream = std::make_unique<SharedOutputStream<3, 4>>();
+    CHECK_FALSE( stream->read([](const TrajectoryView<3>&) { }) );
+
+    for (size_t i = 0; i < 5; ++i) {
+        CHECK( otg.update(input, output) == Result::Working );
+        CHECK( stream->push(output) == (i < 4) );
+        if (output.new_calculation) {
+            CHECK( stream->publish(output.trajectory) );
+        }
+        output.pass_to_input(input);
+    }
+    CHECK( stream->size() == 4 );
+
+    OutputSample<3> sample;
+    CHECK( stream->pop(sample) );
+    CHECK( sample.time == doctest::Approx(0.01) );
+    CHECK( sample.new_section == 0 );
+    CHECK( stream->push(output) );
+
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK( stream->pop(sample) );
+    }
+    CHECK( stream->pop(sample) );
+    CHECK( sample.time == output.time );
+    CHECK( array_eq(sample.new_position, output.new_position) );
+    CHECK_FALSE( stream->pop(sample) );
+
+    std::array<double, 3> new_position, new_position_view;
+    output.trajectory.at_time(2.5, new_position);
+    CHECK( stream->read([&](const TrajectoryView<3>& view) {
+        CHECK( view.get_duration() == output.trajectory.get_duration() );
+        view.at_time(2.5, new_position_view);
+    }) );
+    CHECK( new_position == new_position_view );
+
+    // The function gets a consistent copy, even if the snapshot is overwritten meanwhile
+    Trajectory<3> other_trajectory;
+    input.target_position = {-2.0, 1.0, 0.5};
+    CHECK( otg.calculate(input, other_trajectory) == Result::Working );
+    CHECK( other_trajectory.get_duration() != output.trajectory.get_duration() );
+
+    size_t number_of_calls {0};
+    CHECK( stream->read([&](const TrajectoryView<3>& view) {
+        CHECK( stream->publish(other_trajectory) );
+        CHECK( view.get_duration() == output.trajectory.get_duration() );
+        view.at_time(2.5, new_position_view);
+        number_of_calls += 1;
+    }) );
+    CHECK( number_of_calls == 1 );
+    CHECK( new_position == new_position_view );
+
+    // Read while another thread keeps overwriting the snapshot with one of two trajectories
+    std::atomic<bool> is_publishing {true};
+    std::thread publisher([&] {
+        for (size_t i = 0; is_publishing.load(); ++i) {
+            stream->publish((i % 2 == 0) ? output.trajectory : other_trajectory);
+        }
+    });
+
+    std::array<double, 3> other_position;
+    other_trajectory.at_time(2.5, other_position);
+    for (size_t i = 0; i < 1000; ++i) {
+        stream->read([&](const TrajectoryView<3>& view) {
+            view.at_time(2.5, new_position_view);
+            const bool is_first = (view.get_duration() == output.trajectory.get_duration());
+            CHECK( (is_first || view.get_duration() == other_trajectory.get_duration()) );
+            CHECK( new_position_view == (is_first ? new_position : other_position) );
+        });
+    }
+    is_publishing = false;
+    publisher.join();
+}
+
+TEST_CASE("trajectory-handoff") {
+    TrajectoryHandoff<3> handoff {0.01};
+    InputParameter<3> input;
+    OutputParameter<3> output;
+
+    input.current_position = {0.0, -2.0, 0.0};
+    input.target_position = {1.0, -3.0, 2.0};
+    input.max_velocity = {1.0, 1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0, 1.0};
+    input.max_jerk = {1.0, 1.0, 1.0};
+
+    CHECK( handoff.update(output) == Result::Error );
+    CHECK_FALSE( handoff.at_cycle(0, input.current_position, input.current_velocity, input.current_acceleration) );
+
+    CHECK( handoff.calculate(input, handoff.get_cycle()) == Result::Working );
+    CHECK( handoff.update(output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( output.time == doctest::Approx(0.01) );
+    CHECK( handoff.update(output) == Result::Working );
+    CHECK_FALSE( output.new_calculation );
+    CHECK( output.time == doctest::Approx(0.02) );
+
+    // Replan from a future cycle, while the real-time thread continues
+    const uint64_t start_cycle = handoff.get_cycle() + 3;
+    std::array<double, 3> position_at_start, velocity_at_start, acceleration_at_start;
+    CHECK( handoff.at_cycle(start_cycle, position_at_start, velocity_at_start, acceleration_at_start) );
+    input.current_position = position_at_start;
+    input.current_velocity = velocity_at_start;
+    input.current_acceleration = acceleration_at_start;
+    input.target_position = {-1.0, 1.0, 0.5};
+    CHECK( handoff.calculate(input, start_cycle) == Result::Working );
+
+    // The published trajectory has no state before its start cycle
+    std::array<double, 3> position_before, velocity_before, acceleration_before;
+    CHECK_FALSE( handoff.at_cycle(start_cycle - 1, position_before, velocity_before, acceleration_before) );
+    CHECK( handoff.at_cycle(start_cycle, position_before, velocity_before, acceleration_before) );
+    CHECK( array_eq(position_before, position_at_start) );
+
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK( handoff.update(output) == Result::Working );
+        CHECK_FALSE( output.new_calculation );
+    }
+    CHECK( handoff.update(output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( output.time == doctest::Approx(0.0) );
+    CHECK( array_eq(output.new_position, position_at_start) );
+
+    // A trajectory that is picked up late is sampled at the rebased time
+    CHECK( handoff.update(output) == Result::Working );
+    CHECK( handoff.at_cycle(handoff.get_cycle() - 1, input.current_position, input.current_velocity, input.current_acceleration) );
+    input.target_position = {0.0, 0.0, 0.0};
+    CHECK( handoff.calculate(input, handoff.get_cycle() - 1) == Result::Working );
+    CHECK( handoff.update(output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( output.time == doctest::Approx(0.02) );
+
+    std::array<double, 3> new_position;
+    handoff.get_trajectory().at_time(0.02, new_position);
+    CHECK( array_eq(output.new_position, new_position) );
+
+    while (handoff.update(output) == Result::Working) { }
+    CHECK( array_eq(output.new_position, input.target_position) );
+}
+
+TEST_CASE("calculation-error") {
+    Ruckig<1> otg {0.01};
+    InputParameter<1> input;
+    OutputParameter<1> output;
+
+    input.current_position = {0.0};
+    input.target_position = {1.0};
+    input.max_velocity = {1.0};
+    input.max_acceleration = {1.0};
+    input.max_jerk = {1.0};
+
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK_FALSE( output.error.has_error() );
+    CHECK( output.error.to_string() == "no error" );
+
+    input.target_position = {std::nan("")};
+    CHECK( otg.update(input, output) == Result::ErrorInvalidInput );
+    CHECK( output.error.result == Result::ErrorInvalidInput );
+    CHECK( output.error.stage == CalculationStage::Validation );
+    CHECK( output.error.dof == 0 );
+
+    // The first invalid DoF is reported for both the limits and the state
+    Ruckig<3> otg_3 {0.01};
+    InputParameter<3> input_3;
+    OutputParameter<3> output_3;
+    input_3.target_position = {1.0, 1.0, 1.0};
+    input_3.max_velocity = {1.0, 1.0, 1.0};
+    input_3.max_acceleration = {1.0, 1.0, 1.0};
+    input_3.max_jerk = {1.0, -1.0, 1.0};
+    CHECK( otg_3.update(input_3, output_3) == Result::ErrorInvalidInput );
+    CHECK( output_3.error.dof == 1 );
+
+    input_3.max_jerk = {1.0, 1.0, 1.0};
+    input_3.current_velocity = {0.0, 0.0, std::nan("")};
+    CHECK( otg_3.update(input_3, output_3) == Result::ErrorInvalidInput );
+    CHECK( output_3.error.dof == 2 );
+
+    input_3.current_velocity = {0.0, 0.0, 0.0};
+    CHECK( otg_3.update(input_3, output_3) == Result::Working );
+    CHECK_FALSE( output_3.error.dof );
+
+    input.target_position = {1.0};
+    TargetCalculator<1> calculator;
+    Trajectory<1> trajectory;
+    CHECK( calculator.calculate_with_duration<false>(input, trajectory, 0.5) == Result::ErrorSynchronizationCalculation );
+    CHECK( calculator.error.stage == CalculationStage::TimeSynchronization );
+    CHECK( calculator.error.dof == 0 );
+    CHECK( calculator.error.duration == doctest::Approx(0.5) );
+    CHECK( calculator.error.to_string() == "error in step 2 during time synchronization, dof: 0, duration: 0.500000" );
+
+    bool was_interrupted {false};
+    CHECK( calculator.calculate<false>(input, trajectory, 0.01, was_interrupted) == Result::Working );
+    CHECK_FALSE( calculator.error.has_error() );
+}
+
+TEST_CASE("duration-sweep") {
+    TargetCalculator<2> calculator;
+    InputParameter<2> input;
+    Trajectory<2> trajectory;
+
+    input.current_position = {0.0, 0.0};
+    input.target_position = {1.0, -0.5};
+    input.max_velocity = {1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0};
+    input.max_jerk = {1.0, 1.0};
+
+    CHECK( calculator.calculate_at_duration<false>(input, trajectory, 4.0) == Result::Error );
+
+    CHECK( calculator.calculate_blocks<false>(input, trajectory) == Result::Working );
+    CHECK( calculator.get_block(0).t_min == doctest::Approx(3.1748) );
+    CHECK( calculator.is_blocked(3.0) );
+    CHECK_FALSE( calculator.is_blocked(4.0) );
+
+    const std::array<double, 4> durations {3.0, calculator.get_block(0).t_min, 4.0, 5.0};
+    std::array<Result, 4> results;
+    calculator.calculate_at_durations(input, trajectory, durations.begin(), durations.end(), results.begin());
+    CHECK( results[0] == Result::ErrorSynchronizationCalculation );
+    CHECK( results[1] == Result::Working );
+    CHECK( results[2] == Result::Working );
+    CHECK( results[3] == Result::Working );
+
+    std::array<double, 2> new_position, new_velocity, new_acceleration;
+    CHECK( trajectory.get_duration() == doctest::Approx(5.0) );
+    trajectory.at_time(5.0, new_position, new_velocity, new_acceleration);
+    CHECK( array_eq(new_position, input.target_position) );
+
+    // Compare with the full calculation for a minimum duration
+    Trajectory<2> full_trajectory;
+    input.minimum_duration = 4.0;
+    bool was_interrupted {false};
+    CHECK( calculator.calculate_at_duration<false>(input, trajectory, 4.0) == Result::Working );
+    CHECK( calculator.calculate<false>(input, full_trajectory, 0.01, was_interrupted) == Result::Working );
+    trajectory.at_time(2.0, new_position);
+    std::array<double, 2> full_position;
+    full_trajectory.at_time(2.0, full_position);
+    CHECK( array_eq(new_position, full_position) );
+}
+
+TEST_CASE("group-calculator") {
+    GroupCalculator<2> group {2};
+    std::vector<InputParameter<2>> inputs(2);
+    std::vector<Trajectory<2>> trajectories(2);
+
+    inputs[0].current_position = {0.0, 0.0};
+    inputs[0].target_position = {1.0, -0.5};
+    inputs[0].max_velocity = {1.0, 1.0};
+    inputs[0].max_acceleration = {1.0, 1.0};
+    inputs[0].max_jerk = {1.0, 1.0};
+
+    inputs[1].current_position = {2.0, 0.0};
+    inputs[1].target_position = {0.0, 0.5};
+    inputs[1].target_velocity = {-0.2, 0.0};
+    inputs[1].max_velocity = {2.0, 1.0};
+    inputs[1].max_acceleration = {1.0, 2.0};
+    inputs[1].max_jerk = {3.0, 1.0};
+
+    Ruckig<2> otg;
+    Trajectory<2> independent_trajectory;
+    double independent_duration {0.0};
+    for (const auto& input: inputs) {
+        CHECK( otg.calculate(input, independent_trajectory) == Result::Working );
+        independent_duration = std::max(independent_duration, independent_trajectory.get_duration());
+    }
+
+    for (const bool parallel: {false, true}) {
+        group.parallel = parallel;
+        CHECK( group.calculate(inputs, trajectories) == Result::Working );
+        CHECK_FALSE( group.error.has_error() );
+        CHECK( trajectories[0].get_duration() == doctest::Approx(independent_duration) );
+        CHECK( trajectories[1].get_duration() == doctest::Approx(independent_duration) );
+
+        for (size_t member = 0; member < 2; ++member) {
+            std::array<double, 2> new_position, new_velocity, new_acceleration;
+            trajectories[member].at_time(trajectories[member].get_duration(), new_position, new_velocity, new_acceleration);
+            CHECK( array_eq(new_position, inputs[member].target_position) );
+            CHECK( array_eq(new_velocity, inputs[member].target_velocity) );
+        }
+    }
+
+    inputs[1].minimum_duration = 8.0;
+    CHECK( group.calculate(inputs, trajectories) == Result::Working );
+    CHECK( trajectories[0].get_duration() == doctest::Approx(8.0) );
+    CHECK( trajectories[1].get_duration() == doctest::Approx(8.0) );
+
+    // Discrete durations are rounded up to the control cycle of the group
+    inputs[1].minimum_duration = std::nullopt;
+    inputs[0].duration_discretization = DurationDiscretization::Discrete;
+    CHECK( group.calculate(inputs, trajectories) == Result::ErrorInvalidInput );
+
+    GroupCalculator<2> discrete_group {2, 0.3};
+    CHECK( discrete_group.calculate(inputs, trajectories) == Result::Working );
+    CHECK( trajectories[0].get_duration() >= independent_duration );
+    CHECK( trajectories[0].get_duration() / 0.3 == doctest::Approx(std::round(trajectories[0].get_duration() / 0.3)) );
+    CHECK( trajectories[1].get_duration() == trajectories[0].get_duration() );
+    for (size_t member = 0; member < 2; ++member) {
+        std::array<double, 2> new_position;
+        trajectories[member].at_time(trajectories[member].get_duration(), new_position);
+        CHECK( array_eq(new_position, inputs[member].target_position) );
+    }
+
+    // The number of inputs and trajectories needs to match the group size
+    trajectories.resize(1);
+    CHECK( group.calculate(inputs, trajectories) == Result::ErrorInvalidInput );
+    CHECK( group.error.result == Result::ErrorInvalidInput );
+}
+
+TEST_CASE("brake-pre-check") {
+    std::mt19937 gen {static_cast<std::mt19937::result_type>(seed)};
+    BrakeProfile brake;
+
+    size_t within_limits {0};
+    for (size_t i = 0; i < 1024; ++i) {
+        const double v0 = dynamic_dist(gen), a0 = dynamic_dist(gen);
+        const double vMax = limit_dist(gen), aMax = limit_dist(gen), jMax = limit_dist(gen);
+        if (BrakeProfile::is_within_position_limits(v0, a0, vMax, -vMax, aMax, -aMax, jMax)) {
+            brake.get_position_brake_trajectory(v0, a0, vMax, -vMax, aMax, -aMax, jMax);
+            CHECK( brake.t[0] == 0.0 );
+            CHECK( brake.t[1] == 0.0 );
+            within_limits += 1;
+        }
+    }
+    CHECK( within_limits > 0 );
+
+    CHECK_FALSE( BrakeProfile::is_within_position_limits(1.0, 0.0, 0.5, -0.5, 1.0, -1.0, 1.0) );
+    CHECK_FALSE( BrakeProfile::is_within_position_limits(0.4, 1.0, 0.5, -0.5, 1.0, -1.0, 1.0) );
+    CHECK( BrakeProfile::is_within_position_limits(0.4, -1.0, 0.5, -0.5, 1.0, -1.0, 1.0) );
+}
+
+TEST_CASE("stop-calculator") {
+    StopCalculator<3> stop;
+    InputParameter<3> input;
+    Trajectory<3> trajectory;
+
+    input.current_position = {0.0, 0.0, 0.5};
+    input.current_velocity = {1.0, -2.2, -0.5};
+    input.current_acceleration = {0.0, 2.5, -0.5};
+    input.max_velocity = {3.0, 1.0, 3.0};
+    input.max_acceleration = {3.0, 2.0, 1.0};
+    input.max_jerk = {12.0, 10.0, 8.0};
+
+    CHECK( stop.calculate(input, trajectory) == Result::Working );
+
+    // Compare with the generic calculation in the velocity interface
+    Ruckig<3> otg;
+    Trajectory<3> velocity_trajectory;
+    input.control_interface = ControlInterface::Velocity;
+    input.synchronization = Synchronization::None;
+    CHECK( otg.calculate(input, velocity_trajectory) == Result::Working );
+    CHECK( trajectory.get_duration() == doctest::Approx(velocity_trajectory.get_duration()) );
+    CHECK( array_eq(trajectory.get_independent_min_durations(), velocity_trajectory.get_independent_min_durations()) );
+
+    std::array<double, 3> new_position, new_velocity, new_acceleration, velocity_position;
+    trajectory.at_time(trajectory.get_duration(), new_position, new_velocity, new_acceleration);
+    velocity_trajectory.at_time(trajectory.get_duration(), velocity_position);
+    CHECK( array_eq(new_position, velocity_position) );
+    CHECK( array_eq(new_velocity, {0.0, 0.0, 0.0}) );
+    CHECK( array_eq(new_acceleration, {0.0, 0.0, 0.0}) );
+
+    CHECK( stop.calculate(input, trajectory, true) == Result::Working );
+    CHECK( trajectory.get_duration() == doctest::Approx(velocity_trajectory.get_duration()) );
+    for (size_t dof = 0; dof < 3; ++dof) {
+        CHECK( trajectory.get_profiles()[0][dof].t_sum.back() + trajectory.get_profiles()[0][dof].brake.duration == doctest::Approx(trajectory.get_duration()) );
+    }
+    trajectory.at_time(trajectory.get_duration(), new_position, new_velocity, new_acceleration);
+    CHECK( array_eq(new_velocity, {0.0, 0.0, 0.0}) );
+    CHECK( array_eq(new_acceleration, {0.0, 0.0, 0.0}) );
+
+    input.max_jerk = {0.0, 10.0, 8.0};
+    CHECK( stop.calculate(input, trajectory) == Result::ErrorZeroLimits );
+    CHECK( stop.error.dof == 0 );
+}
+
 TEST_CASE("zero-limits") {
     RuckigThrow<3> otg {0.005};
     InputParameter<3> input;